@@ -0,0 +1,714 @@
+/***************************
+ ** File:    bucketshow.cpp
+ ** Project: extension of CMSC 341, proj2, Spring 2023
+ ** Author:  Show maintainers, not part of the original project
+ ** Date:    10/17/2026
+ **
+ ** This file defines the functions laid out in bucketshow.h, a Show whose AVL nodes
+ ** each hold a small sorted array of drones
+ **
+*****************************/
+
+#include "bucketshow.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//Default constructor
+//Sets m_root to nullptr, every count lives in the buckets
+BucketShow::BucketShow(){
+    m_root = nullptr;
+}
+
+//Destructor
+//Calls upon clear to entirely clear and delete the object
+BucketShow::~BucketShow(){
+    clear();
+}
+
+//operator=
+//assigns an rhs to another, avoids self assignment
+const BucketShow & BucketShow::operator=(const BucketShow & rhs){
+    if (this != &rhs){
+        clear();
+        m_root = preOrderAssignment(rhs.m_root);
+    }
+    return *this;
+}
+
+//insert
+//adds a new drone, reports whether it was inserted, a duplicate, or invalid
+INSERTRESULT BucketShow::insert(const Drone& aDrone){
+    return insert(aDrone.getID(), aDrone.getType(), aDrone.getState());
+}
+
+//insert
+//finds the bucket whose range holds id, or the last bucket passed if none does, and adds the drone to it
+//a full bucket is split first, and its upper half becomes a new bucket in the tree
+INSERTRESULT BucketShow::insert(int id, LIGHTCOLOR type, STATE state){
+    //if statement checks to ensure that the ID, light color, and state are all valid
+    if ((id < MINID) || (id > MAXID) || ((type != RED) && (type != GREEN) && (type != BLUE))
+        || ((state != LIGHTON) && (state != LIGHTOFF))){
+        return INVALID;
+    }
+
+    DroneBucket** path[MAXDEPTH];
+    int depth = descend(id, path);
+    //if the tree is empty the first bucket is made
+    if (depth == 0){
+        m_root = new DroneBucket();
+        path[depth++] = &m_root;
+    }
+    else if (searchBucket(*path[depth - 1], id) != -1){
+        return DUPLICATE;
+    }
+
+    DroneBucket* target = *path[depth - 1];
+    DroneBucket* upper = nullptr;
+    //if the bucket is full, its upper half is moved to a new bucket, which is linked once the drone is in place
+    if (target->m_numDrones == BUCKET_SIZE){
+        upper = new DroneBucket();
+        int half = BUCKET_SIZE / 2;
+        for (int i = half; i < BUCKET_SIZE; i++){
+            upper->m_ids[i - half] = target->m_ids[i];
+            upper->m_types[i - half] = target->m_types[i];
+            upper->m_states[i - half] = target->m_states[i];
+        }
+        upper->m_numDrones = BUCKET_SIZE - half;
+        target->m_numDrones = half;
+        if (id > target->getMaxID()){
+            target = upper;
+        }
+    }
+
+    //while loop shifts the larger IDs up one slot to make room
+    int slot = target->m_numDrones;
+    while ((slot > 0) && (target->m_ids[slot - 1] > id)){
+        target->m_ids[slot] = target->m_ids[slot - 1];
+        target->m_types[slot] = target->m_types[slot - 1];
+        target->m_states[slot] = target->m_states[slot - 1];
+        slot--;
+    }
+    target->m_ids[slot] = id;
+    target->m_types[slot] = type;
+    target->m_states[slot] = state;
+    target->m_numDrones++;
+
+    //the buckets on the path gained or lost drones, so their counts are pulled again
+    rebalancePath(path, depth);
+    if (upper != nullptr){
+        linkBucket(upper);
+    }
+    return INSERTED;
+}
+
+//clear
+//deletes the entire tree
+void BucketShow::clear(){
+    recursiveClear(m_root);
+    m_root = nullptr;
+}
+
+//loadRoster
+//drops invalid drones, sorts and dedupes the rest, merges them with the tree, and packs them into buckets in O(n)
+//for a duplicate ID the drone already in the tree wins, then the first one in the roster, just like insert
+int BucketShow::loadRoster(vector<Drone>& roster){
+    //for loop keeps only the drones which insert would accept
+    int numValid = 0;
+    for (unsigned int i = 0; i < roster.size(); i++){
+        int id = roster[i].getID();
+        LIGHTCOLOR type = roster[i].getType();
+        STATE state = roster[i].getState();
+        if ((id >= MINID) && (id <= MAXID) && ((type == RED) || (type == GREEN) || (type == BLUE))
+            && ((state == LIGHTON) || (state == LIGHTOFF))){
+            roster[numValid++] = roster[i];
+        }
+    }
+    roster.resize(numValid);
+
+    //stable sort keeps duplicates in their original order, so unique keeps the first of each
+    stable_sort(roster.begin(), roster.end(),
+        [](const Drone& lhs, const Drone& rhs){return lhs.getID() < rhs.getID();});
+    roster.erase(unique(roster.begin(), roster.end(),
+        [](const Drone& lhs, const Drone& rhs){return lhs.getID() == rhs.getID();}), roster.end());
+
+    vector<DroneBucket*> buckets;
+    flattenInorder(m_root, buckets);
+    vector<Drone> drones;
+    drones.reserve(countDrones() + roster.size());
+    unsigned int b = 0;
+    int i = 0;
+    unsigned int j = 0;
+    int added = 0;
+    //while loop merges the drones of the buckets with the roster, skipping roster drones already in the tree
+    while ((b < buckets.size()) || (j < roster.size())){
+        if ((b < buckets.size()) && (i == buckets[b]->m_numDrones)){
+            b++;
+            i = 0;
+        }
+        else if ((j == roster.size()) || ((b < buckets.size()) && (buckets[b]->m_ids[i] < roster[j].getID()))){
+            drones.push_back(buckets[b]->makeDrone(i++));
+        }
+        else if ((b < buckets.size()) && (buckets[b]->m_ids[i] == roster[j].getID())){
+            j++; //duplicate, the drone already in the tree is kept
+        }
+        else{
+            drones.push_back(roster[j++]);
+            added++;
+        }
+    }
+    packBuckets(buckets, drones, BUCKET_FILL);
+    return added;
+}
+
+//remove
+//removes the drone from its bucket, an empty bucket leaves the tree and a nearly empty one is merged with the next
+REMOVERESULT BucketShow::remove(int id){
+    DroneBucket** path[MAXDEPTH];
+    int depth = descend(id, path);
+    DroneBucket* target = ((depth == 0) ? nullptr : *path[depth - 1]);
+    int slot = ((target == nullptr) ? -1 : searchBucket(target, id));
+    if (slot == -1){
+        return ABSENT;
+    }
+
+    //for loop shifts the larger IDs down over the removed one
+    for (int i = slot + 1; i < target->m_numDrones; i++){
+        target->m_ids[i - 1] = target->m_ids[i];
+        target->m_types[i - 1] = target->m_types[i];
+        target->m_states[i - 1] = target->m_states[i];
+    }
+    target->m_numDrones--;
+
+    //if the bucket is empty it leaves the tree
+    if (target->m_numDrones == 0){
+        unlinkBucket(target, id);
+        return REMOVED;
+    }
+    //if it is nearly empty, the next bucket is merged into it when both fit with room to spare
+    DroneBucket* next = nullptr;
+    if (target->m_numDrones < BUCKET_MERGE){
+        int maxID = target->getMaxID();
+        for (DroneBucket* curr = m_root; curr != nullptr;){
+            if (curr->getMinID() > maxID){
+                next = curr;
+                curr = curr->m_left;
+            }
+            else{
+                curr = curr->m_right;
+            }
+        }
+        if ((next != nullptr) && (target->m_numDrones + next->m_numDrones > BUCKET_SIZE - BUCKET_MERGE)){
+            next = nullptr;
+        }
+    }
+    int nextID = ((next == nullptr) ? 0 : next->getMinID());
+    if (next != nullptr){
+        for (int i = 0; i < next->m_numDrones; i++){
+            target->m_ids[target->m_numDrones] = next->m_ids[i];
+            target->m_types[target->m_numDrones] = next->m_types[i];
+            target->m_states[target->m_numDrones] = next->m_states[i];
+            target->m_numDrones++;
+        }
+        next->m_numDrones = 0;
+    }
+    //the counts on target's path are pulled first, then the emptied bucket's path is pulled as it leaves
+    rebalancePath(path, depth);
+    if (next != nullptr){
+        unlinkBucket(next, nextID);
+    }
+    return REMOVED;
+}
+
+//dumpTree and dump
+//output the tree, each bucket is shown as its range and height
+void BucketShow::dumpTree() const {dump(m_root);}
+void BucketShow::dump(DroneBucket* aBucket) const{
+    if (aBucket != nullptr){
+        cout << "(";
+        dump(aBucket->m_left);//first visit the left child
+        cout << aBucket->getMinID() << "-" << aBucket->getMaxID() << ":" << aBucket->m_height;//second visit the bucket itself
+        dump(aBucket->m_right);//third visit the right child
+        cout << ")";
+    }
+}
+
+//listDrones
+//list all of the drones within the tree
+void BucketShow::listDrones() const{
+    if (m_root == nullptr){
+        cout << "Empty tree" << endl;
+    }
+    else{
+        inorderList(m_root);
+    }
+}
+
+//setState
+//finds the ID, and changes the state, the counts on the path are pulled again
+bool BucketShow::setState(int id, STATE state){
+    if ((state != LIGHTON) && (state != LIGHTOFF)){
+        return false;
+    }
+    DroneBucket** path[MAXDEPTH];
+    int depth = descend(id, path);
+    DroneBucket* target = ((depth == 0) ? nullptr : *path[depth - 1]);
+    int slot = ((target == nullptr) ? -1 : searchBucket(target, id));
+    //if statement checks to ensure the drone exists and that the states are different
+    if ((slot == -1) || (target->m_states[slot] == state)){
+        return false;
+    }
+    target->m_states[slot] = state;
+    rebalancePath(path, depth);
+    return true;
+}
+
+//removeLightOff
+//removes every drone that is off in one pass
+void BucketShow::removeLightOff(){
+    removeIf([](const Drone& aDrone){return aDrone.getState() == LIGHTOFF;});
+}
+
+//findDrone
+//Finds the drone within the tree
+bool BucketShow::findDrone(int id) const{
+    DroneBucket* target = findBucket(id);
+    return (target != nullptr) && (searchBucket(target, id) != -1);
+}
+
+//findDrones
+//the descents are a few buckets deep, so each lookup is made on its own
+void BucketShow::findDrones(const int ids[], int numIds, bool found[]) const{
+    for (int i = 0; i < numIds; i++){
+        found[i] = findDrone(ids[i]);
+    }
+}
+
+//setStates
+//applies each update in order, exactly as setState would
+void BucketShow::setStates(const pair<int, STATE> updates[], int numUpdates, bool changed[]){
+    for (int i = 0; i < numUpdates; i++){
+        changed[i] = setState(updates[i].first, updates[i].second);
+    }
+}
+
+//rank
+//adds up the subtree sizes and buckets passed on the left, then the slots below id in the bucket holding it
+int BucketShow::rank(int id) const{
+    int count = 0;
+    const DroneBucket* curr = m_root;
+    while (curr != nullptr){
+        if (id <= curr->getMinID()){
+            curr = curr->m_left;
+        }
+        else if (id > curr->getMaxID()){
+            count += sizeOf(curr->m_left) + curr->m_numDrones;
+            curr = curr->m_right;
+        }
+        else{
+            return count + sizeOf(curr->m_left) + slotOf(curr, id);
+        }
+    }
+    return count;
+}
+
+//select
+//descends by the subtree sizes to the bucket holding position k, then indexes into it
+int BucketShow::select(int k) const{
+    if ((k < 0) || (k >= countDrones())){
+        return NO_DRONE;
+    }
+    const DroneBucket* curr = m_root;
+    while (curr != nullptr){
+        int leftSize = sizeOf(curr->m_left);
+        if (k < leftSize){
+            curr = curr->m_left;
+        }
+        else if (k < leftSize + curr->m_numDrones){
+            return curr->m_ids[k - leftSize];
+        }
+        else{
+            k -= leftSize + curr->m_numDrones;
+            curr = curr->m_right;
+        }
+    }
+    return NO_DRONE;
+}
+
+//listDrones
+//finds position offset with select, then copies drones in order from there
+int BucketShow::listDrones(int offset, int limit, Drone buffer[]) const{
+    if ((offset < 0) || (limit <= 0)){
+        return 0;
+    }
+    int id = select(offset);
+    if (id == NO_DRONE){
+        return 0;
+    }
+    int numCopied = 0;
+    walkFrom(id, [&](const Drone& aDrone){
+        buffer[numCopied++] = aDrone;
+        return numCopied < limit;
+    });
+    return numCopied;
+}
+
+//sampleDrone
+//picks a uniform position and selects it
+int BucketShow::sampleDrone(mt19937& generator) const{
+    if (countDrones() == 0){
+        return NO_DRONE;
+    }
+    uniform_int_distribution<int> position(0, countDrones() - 1);
+    return select(position(generator));
+}
+
+//floor
+//the largest ID of the last bucket passed on the right, unless a bucket's range holds id
+int BucketShow::floor(int id) const{
+    int best = NO_DRONE;
+    const DroneBucket* curr = m_root;
+    while (curr != nullptr){
+        if (id < curr->getMinID()){
+            curr = curr->m_left;
+        }
+        else if (id > curr->getMaxID()){
+            best = curr->getMaxID();
+            curr = curr->m_right;
+        }
+        else{
+            int slot = slotOf(curr, id);
+            return ((curr->m_ids[slot] == id) ? id : curr->m_ids[slot - 1]);
+        }
+    }
+    return best;
+}
+
+//ceiling
+//the smallest ID of the last bucket passed on the left, unless a bucket's range holds id
+int BucketShow::ceiling(int id) const{
+    int best = NO_DRONE;
+    const DroneBucket* curr = m_root;
+    while (curr != nullptr){
+        if (id > curr->getMaxID()){
+            curr = curr->m_right;
+        }
+        else if (id < curr->getMinID()){
+            best = curr->getMinID();
+            curr = curr->m_left;
+        }
+        else{
+            return curr->m_ids[slotOf(curr, id)];
+        }
+    }
+    return best;
+}
+
+//successor
+//the first ID in use after id
+int BucketShow::successor(int id) const{
+    return ((id >= MAXID) ? NO_DRONE : ceiling(id + 1));
+}
+
+//predecessor
+//the last ID in use before id
+int BucketShow::predecessor(int id) const{
+    return ((id <= MINID) ? NO_DRONE : floor(id - 1));
+}
+
+//removeRange
+//the buckets straddling either end are trimmed in place, which leaves every bucket wholly inside or outside the range
+//then two splits by smallest ID cut out the buckets inside, which are deleted, and the rest are joined in O(log n + k / BUCKET_SIZE)
+int BucketShow::removeRange(int loId, int hiId){
+    if (hiId > MAXID){
+        hiId = MAXID;
+    }
+    if (loId > hiId){
+        return 0;
+    }
+    int numRemoved = trimBucket(loId, loId, hiId) + trimBucket(hiId, loId, hiId);
+    DroneBucket* below;
+    DroneBucket* rest;
+    DroneBucket* middle;
+    DroneBucket* above;
+    BucketKernels::split(m_root, loId, below, rest);
+    BucketKernels::split(rest, hiId + 1, middle, above);
+    numRemoved += sizeOf(middle);
+    recursiveClear(middle);
+    m_root = BucketKernels::joinTrees(below, above);
+    return numRemoved;
+}
+
+//countDrones
+//the counts are pulled up to the root by every change, so each is read there
+int BucketShow::countDrones() const{
+    return sizeOf(m_root);
+}
+int BucketShow::countDrones(LIGHTCOLOR aColor) const{
+    if ((aColor < RED) || (aColor > BLUE)){
+        return 0;
+    }
+    return countOf(m_root, aColor, LIGHTON) + countOf(m_root, aColor, LIGHTOFF);
+}
+int BucketShow::countDrones(STATE aState) const{
+    if ((aState < LIGHTON) || (aState > LIGHTOFF)){
+        return 0;
+    }
+    int count = 0;
+    for (int i = 0; i < NUMCOLORS; i++){
+        count += countOf(m_root, static_cast<LIGHTCOLOR>(i), aState);
+    }
+    return count;
+}
+
+//countDrones
+//the difference of two descents by the subtree counts, only the two end buckets are scanned
+int BucketShow::countDrones(LIGHTCOLOR aColor, STATE aState, int loId, int hiId) const{
+    if ((aColor < RED) || (aColor > BLUE) || (aState < LIGHTON) || (aState > LIGHTOFF) || (loId > hiId)){
+        return 0;
+    }
+    if (hiId > MAXID){
+        hiId = MAXID;
+    }
+    return countBelow(aColor, aState, hiId + 1) - countBelow(aColor, aState, loId);
+}
+
+//freeze
+//the buckets already list the IDs in order, so they are copied straight into the snapshot
+FrozenShow BucketShow::freeze() const{
+    vector<int> ids;
+    ids.reserve(countDrones());
+    walkFrom(MINID, [&](const Drone& aDrone){
+        ids.push_back(aDrone.getID());
+        return true;
+    });
+    return FrozenShow(ids.data(), ids.size());
+}
+
+//findBucket
+//descends by comparing id with each bucket's range
+DroneBucket* BucketShow::findBucket(int id) const{
+    DroneBucket* curr = m_root;
+    while (curr != nullptr){
+        if (id < curr->getMinID()){
+            curr = curr->m_left;
+        }
+        else if (id > curr->getMaxID()){
+            curr = curr->m_right;
+        }
+        else{
+            return curr;
+        }
+    }
+    return nullptr;
+}
+
+//searchBucket
+//compares id with four IDs at a time using SSE2, or one at a time without it
+//the last group may reach past the end of the bucket, so only the lanes holding drones are kept
+int BucketShow::searchBucket(const DroneBucket* aBucket, int id){
+#ifdef __SSE2__
+    __m128i key = _mm_set1_epi32(id);
+    for (int i = 0; i < aBucket->m_numDrones; i += 4){
+        __m128i ids = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aBucket->m_ids + i));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(ids, key)));
+        if (aBucket->m_numDrones - i < 4){
+            mask &= (1 << (aBucket->m_numDrones - i)) - 1;
+        }
+        if (mask != 0){
+            return i + __builtin_ctz(mask);
+        }
+    }
+#else
+    for (int i = 0; i < aBucket->m_numDrones; i++){
+        if (aBucket->m_ids[i] == id){
+            return i;
+        }
+    }
+#endif
+    return -1;
+}
+
+//slotOf
+//binary search within the bucket
+int BucketShow::slotOf(const DroneBucket* aBucket, int id){
+    return std::lower_bound(aBucket->m_ids, aBucket->m_ids + aBucket->m_numDrones, id) - aBucket->m_ids;
+}
+
+//descend
+//records the links from m_root down to the bucket whose range holds id, or the last bucket passed if none does
+//if no range holds id, the last bucket passed is next to where id belongs, so it can grow to take it
+int BucketShow::descend(int id, DroneBucket** path[]){
+    int depth = 0;
+    DroneBucket** link = &m_root;
+    while (*link != nullptr){
+        path[depth++] = link;
+        DroneBucket* curr = *link;
+        if (id < curr->getMinID()){
+            link = &curr->m_left;
+        }
+        else if (id > curr->getMaxID()){
+            link = &curr->m_right;
+        }
+        else{
+            break;
+        }
+    }
+    return depth;
+}
+
+//linkBucket
+//descends by the bucket's smallest ID to an empty link, hangs it there, and rebalances the path
+void BucketShow::linkBucket(DroneBucket* aBucket){
+    DroneBucket** path[MAXDEPTH];
+    int depth = 0;
+    DroneBucket** link = &m_root;
+    while (*link != nullptr){
+        path[depth++] = link;
+        link = ((aBucket->getMinID() < (*link)->getMinID()) ? &(*link)->m_left : &(*link)->m_right);
+    }
+    *link = aBucket;
+    path[depth++] = link;
+    rebalancePath(path, depth);
+}
+
+//unlinkBucket
+//aBucket may already be empty, so it is recognized by its address rather than its range
+//a bucket with two children is replaced by joining them around the smallest bucket of its right subtree
+void BucketShow::unlinkBucket(DroneBucket* aBucket, int id){
+    DroneBucket** path[MAXDEPTH];
+    int depth = 0;
+    DroneBucket** link = &m_root;
+    while (*link != aBucket){
+        path[depth++] = link;
+        link = ((id < (*link)->getMinID()) ? &(*link)->m_left : &(*link)->m_right);
+    }
+    if ((aBucket->m_left == nullptr) || (aBucket->m_right == nullptr)){
+        *link = ((aBucket->m_left != nullptr) ? aBucket->m_left : aBucket->m_right);
+    }
+    else{
+        DroneBucket* minBucket;
+        DroneBucket* right = BucketKernels::detachMin(aBucket->m_right, minBucket);
+        *link = BucketKernels::join(aBucket->m_left, minBucket, right);
+    }
+    delete aBucket;
+    rebalancePath(path, depth);
+}
+
+//trimBucket
+//a bucket whose range holds id but reaches outside [loId, hiId] keeps the drones outside and stays in the tree
+int BucketShow::trimBucket(int id, int loId, int hiId){
+    DroneBucket** path[MAXDEPTH];
+    int depth = descend(id, path);
+    DroneBucket* target = ((depth == 0) ? nullptr : *path[depth - 1]);
+    if ((target == nullptr) || (id < target->getMinID()) || (id > target->getMaxID())
+        || ((target->getMinID() >= loId) && (target->getMaxID() <= hiId))){
+        return 0;
+    }
+    int kept = 0;
+    for (int i = 0; i < target->m_numDrones; i++){
+        if ((target->m_ids[i] < loId) || (target->m_ids[i] > hiId)){
+            target->m_ids[kept] = target->m_ids[i];
+            target->m_types[kept] = target->m_types[i];
+            target->m_states[kept] = target->m_states[i];
+            kept++;
+        }
+    }
+    int numRemoved = target->m_numDrones - kept;
+    target->m_numDrones = kept;
+    rebalancePath(path, depth);
+    return numRemoved;
+}
+
+//countBelow
+//adds up the matching counts of the subtrees passed on the left, and scans the slots below id in the buckets passed
+int BucketShow::countBelow(LIGHTCOLOR color, STATE state, int id) const{
+    int count = 0;
+    const DroneBucket* curr = m_root;
+    while (curr != nullptr){
+        if (id <= curr->getMinID()){
+            curr = curr->m_left;
+            continue;
+        }
+        count += countOf(curr->m_left, color, state);
+        int end = ((id > curr->getMaxID()) ? curr->m_numDrones : slotOf(curr, id));
+        for (int i = 0; i < end; i++){
+            count += ((curr->m_types[i] == color) && (curr->m_states[i] == state));
+        }
+        if (end < curr->m_numDrones){
+            return count;
+        }
+        curr = curr->m_right;
+    }
+    return count;
+}
+
+//recursiveClear
+//deletes every bucket using postorder traversal
+void BucketShow::recursiveClear(DroneBucket* aBucket){
+    if (aBucket != nullptr){
+        recursiveClear(aBucket->m_left);
+        recursiveClear(aBucket->m_right);
+        delete aBucket;
+    }
+}
+
+//preOrderAssignment
+//copies every bucket of the rhs tree, along with its height and counts
+DroneBucket* BucketShow::preOrderAssignment(const DroneBucket* rhsBucket){
+    if (rhsBucket == nullptr){
+        return nullptr;
+    }
+    DroneBucket* curr = new DroneBucket(*rhsBucket);
+    curr->m_left = preOrderAssignment(rhsBucket->m_left);
+    curr->m_right = preOrderAssignment(rhsBucket->m_right);
+    return curr;
+}
+
+//inorderList
+//prints every drone of every bucket in order
+void BucketShow::inorderList(const DroneBucket* curr) const{
+    if (curr != nullptr){
+        inorderList(curr->m_left);
+        for (int i = 0; i < curr->m_numDrones; i++){
+            Drone aDrone = curr->makeDrone(i);
+            cout << aDrone.getID() << ":" << aDrone.getStateStr() << ":" << aDrone.getTypeStr() << endl;
+        }
+        inorderList(curr->m_right);
+    }
+}
+
+//flattenInorder
+//appends every bucket of the subtree to buckets, in order
+void BucketShow::flattenInorder(DroneBucket* curr, vector<DroneBucket*>& buckets){
+    if (curr != nullptr){
+        flattenInorder(curr->m_left, buckets);
+        buckets.push_back(curr);
+        flattenInorder(curr->m_right, buckets);
+    }
+}
+
+//packBuckets
+//fills buckets front to back with up to fill drones each, reusing the old buckets and adding or deleting the difference
+//then links them into a balanced tree with the shared kernel, which pulls every count on the way up
+void BucketShow::packBuckets(vector<DroneBucket*>& buckets, const vector<Drone>& drones, int fill){
+    unsigned int numBuckets = (drones.size() + fill - 1) / fill;
+    for (unsigned int i = numBuckets; i < buckets.size(); i++){
+        delete buckets[i];
+    }
+    buckets.resize(numBuckets, nullptr);
+    for (unsigned int b = 0; b < numBuckets; b++){
+        if (buckets[b] == nullptr){
+            buckets[b] = new DroneBucket();
+        }
+        DroneBucket* curr = buckets[b];
+        curr->m_numDrones = 0;
+        for (unsigned int i = b * fill; (i < drones.size()) && (i < (b + 1) * fill); i++){
+            curr->m_ids[curr->m_numDrones] = drones[i].getID();
+            curr->m_types[curr->m_numDrones] = drones[i].getType();
+            curr->m_states[curr->m_numDrones] = drones[i].getState();
+            curr->m_numDrones++;
+        }
+    }
+    m_root = BucketKernels::buildBalanced(buckets.data(), numBuckets);
+}
@@ -0,0 +1,236 @@
+// Extension of UMBC - CMSC 341 - Spring 2023 - Proj2, added by the Show maintainers
+#ifndef BUCKETSHOW_H
+#define BUCKETSHOW_H
+#include <algorithm>
+#include "show.h"
+const int BUCKET_SIZE = 32;//the most drones one bucket holds, a multiple of four so the SIMD search never reads past the array
+const int BUCKET_MERGE = BUCKET_SIZE / 4;//a bucket this empty is merged into the next one when they fit together
+const int BUCKET_FILL = BUCKET_SIZE * 3 / 4;//bulkLoad fills buckets this far, leaving room for later inserts
+//DroneBucket
+//one node of a BucketShow, a sorted array of drones whose IDs all fall between its neighbors in the tree
+class DroneBucket{
+    public:
+    friend class BucketShow;
+    friend class BucketTraits;
+    friend class Tester;
+    DroneBucket(){
+        //every slot is set, so the SIMD search compares defined values even past m_numDrones
+        for (int i = 0; i < BUCKET_SIZE; i++){
+            m_ids[i] = 0;
+            m_types[i] = 0;
+            m_states[i] = 0;
+        }
+        for (int i = 0; i < NUMCOLORS * NUMSTATES; i++){
+            m_counts[i] = 0;
+        }
+        m_numDrones = 0;
+        m_size = 0;
+        m_left = nullptr;
+        m_right = nullptr;
+        m_height = DEFAULT_HEIGHT;
+    }
+    int getMinID() const {return m_ids[0];}
+    int getMaxID() const {return m_ids[m_numDrones - 1];}
+    int getNumDrones() const {return m_numDrones;}
+    int getSize() const {return m_size;}//the number of drones in this subtree of buckets
+    int getCount(LIGHTCOLOR type, STATE state) const {return m_counts[type * NUMSTATES + state];}//drones of that color and state in this subtree
+    int getHeight() const {return m_height;}
+    DroneBucket* getLeft() const {return m_left;}
+    DroneBucket* getRight() const {return m_right;}
+    private:
+    int m_ids[BUCKET_SIZE];//the IDs in increasing order, kept apart from the rest so searches only touch them
+    unsigned char m_types[BUCKET_SIZE];//the color of each drone
+    unsigned char m_states[BUCKET_SIZE];//the state of each drone
+    int m_numDrones;//the number of drones in the bucket
+    int m_size;//the number of drones in this subtree of buckets
+    int m_counts[NUMCOLORS * NUMSTATES];//the number of drones of each color and state in this subtree of buckets
+    DroneBucket* m_left;//buckets with smaller IDs
+    DroneBucket* m_right;//buckets with larger IDs
+    int m_height;//the height of the bucket in the tree
+
+    Drone makeDrone(int slot) const {return Drone(m_ids[slot], static_cast<LIGHTCOLOR>(m_types[slot]), static_cast<STATE>(m_states[slot]));}
+};
+//BucketTraits
+//lets the tree kernels in treecore.h work on buckets, keyed by their smallest ID, the pulled data is the size and counters
+class BucketTraits{
+    public:
+    typedef DroneBucket Node;
+    typedef int Key;
+    typedef less<int> Compare;
+    static int key(const DroneBucket* aBucket) {return aBucket->getMinID();}
+    static DroneBucket* left(const DroneBucket* aBucket) {return aBucket->m_left;}
+    static DroneBucket* right(const DroneBucket* aBucket) {return aBucket->m_right;}
+    static void setLeft(DroneBucket* aBucket, DroneBucket* child) {aBucket->m_left = child;}
+    static void setRight(DroneBucket* aBucket, DroneBucket* child) {aBucket->m_right = child;}
+    static int height(const DroneBucket* aBucket) {return aBucket->m_height;}
+    static void setHeight(DroneBucket* aBucket, int height) {aBucket->m_height = height;}
+    static void pull(DroneBucket* aBucket){
+        aBucket->m_size = aBucket->m_numDrones;
+        for (int i = 0; i < NUMCOLORS * NUMSTATES; i++){
+            aBucket->m_counts[i] = 0;
+        }
+        for (int i = 0; i < aBucket->m_numDrones; i++){
+            aBucket->m_counts[aBucket->m_types[i] * NUMSTATES + aBucket->m_states[i]]++;
+        }
+        const DroneBucket* children[2] = {aBucket->m_left, aBucket->m_right};
+        for (int c = 0; c < 2; c++){
+            if (children[c] != nullptr){
+                aBucket->m_size += children[c]->m_size;
+                for (int i = 0; i < NUMCOLORS * NUMSTATES; i++){
+                    aBucket->m_counts[i] += children[c]->m_counts[i];
+                }
+            }
+        }
+    }
+    static void push(DroneBucket*) {}//buckets hold nothing back from their children
+};
+typedef AvlPolicy<BucketTraits> BucketBalance;
+typedef TreeKernels<BucketTraits, BucketBalance> BucketKernels;
+//BucketShow
+//a Show whose AVL nodes each hold up to BUCKET_SIZE drones, which cuts about five levels off every descent
+//every node is a bucket rather than only the leaves, so the upper levels hold drones too and there is one node type,
+//balanced by the same kernels in treecore.h as Show
+//it has Show's public functions for storing, counting, and walking drones, except where a Drone node would be needed:
+//  navigation returns IDs, with NO_DRONE when there is none, since there is no Drone for a pointer to point at
+//  there are no iterators, forEachInRange and listDrones(offset) walk in order instead
+//  reserve is left out, since each bucket is already one contiguous array of drones
+//  bulkLoad and removeIf run on one thread, packing buckets is a single pass
+//options Show has for tuning the layout or balancing of its own Drone nodes are not mirrored, a bucket tree is already short
+class BucketShow{
+    public:
+    friend class Tester;
+    BucketShow();
+    ~BucketShow();
+    BucketShow(const BucketShow&) = delete;
+    const BucketShow & operator=(const BucketShow & rhs);
+    INSERTRESULT insert(const Drone& aDrone);
+    INSERTRESULT insert(int id, LIGHTCOLOR type = DEFAULT_LIGHT, STATE state = DEFAULT_STATE);
+    void clear();
+    template <class Iterator>
+    int bulkLoad(Iterator first, Iterator last);//loads a roster of drones in linear time after sorting, returns how many were added
+    REMOVERESULT remove(int id);
+    void dumpTree() const;
+    void listDrones() const;
+    bool setState(int id, STATE state);
+    void removeLightOff();//removes all LIGHTOFF Drones from the tree
+    template <class Predicate>
+    int removeIf(Predicate shouldRemove);//removes every drone the predicate holds for, returns how many were removed
+    bool findDrone(int id) const;//returns true if the drone is in tree
+    void findDrones(const int ids[], int numIds, bool found[]) const;//batched findDrone
+    void setStates(const pair<int, STATE> updates[], int numUpdates, bool changed[]);//batched setState, applied in order
+    int rank(int id) const;//the number of drones with IDs less than id
+    int select(int k) const;//the ID at position k in ID order, counting from 0, NO_DRONE if out of range
+    int listDrones(int offset, int limit, Drone buffer[]) const;//copies up to limit drones starting at position offset, returns how many
+    int sampleDrone(mt19937& generator) const;//the ID of a uniformly random drone, NO_DRONE if the tree is empty
+    int floor(int id) const;//the largest ID not above id, NO_DRONE if there is none
+    int ceiling(int id) const;//the smallest ID not below id, NO_DRONE if there is none
+    int successor(int id) const;//the smallest ID above id, NO_DRONE if there is none
+    int predecessor(int id) const;//the largest ID below id, NO_DRONE if there is none
+    template <class Function>
+    void forEachInRange(int loId, int hiId, Function visit) const;//calls visit on every drone with an ID in [loId, hiId], in order
+    int removeRange(int loId, int hiId);//removes every drone with an ID in [loId, hiId], returns how many were removed
+    int countDrones() const;//the number of drones in the tree
+    int countDrones(LIGHTCOLOR aColor) const;
+    int countDrones(STATE aState) const;
+    int countDrones(LIGHTCOLOR aColor, STATE aState, int loId, int hiId) const;//counts matching drones with IDs in [loId, hiId]
+    FrozenShow freeze() const;//builds a read only snapshot for fast lookups in O(n), later changes do not reach it
+
+    private:
+    DroneBucket* m_root;//the root of the tree of buckets
+
+    void dump(DroneBucket* aBucket) const;//helper for dumpTree
+    DroneBucket* findBucket(int id) const;//helper for lookups, the bucket whose range holds id
+    static int searchBucket(const DroneBucket* aBucket, int id);//helper for lookups, the slot of id in the bucket or -1
+    static int slotOf(const DroneBucket* aBucket, int id);//helper for navigation, the first slot whose ID is not below id
+    int descend(int id, DroneBucket** path[]);//helper for insert and remove, the links to the bucket holding id or the last one passed
+    void linkBucket(DroneBucket* aBucket);//helper for insert, adds a bucket whose range lies between existing ones
+    void unlinkBucket(DroneBucket* aBucket, int id);//helper for remove, deletes a bucket found by an id that lay in its range
+    int trimBucket(int id, int loId, int hiId);//helper for removeRange, removes the IDs in range from the bucket whose range holds id
+    void rebalancePath(DroneBucket** path[], int depth) {BucketBalance::rebalancePath(path, depth);} //helper for every change, fixes the path
+    static int sizeOf(const DroneBucket* aBucket) {return ((aBucket == nullptr) ? 0 : aBucket->m_size);} //helper for rank and select
+    static int countOf(const DroneBucket* aBucket, LIGHTCOLOR color, STATE state) {return ((aBucket == nullptr) ? 0 : aBucket->getCount(color, state));} //helper for countBelow
+    template <class Function>
+    void walkFrom(int loId, Function visit) const;//helper for forEachInRange and listDrones, visits in order from loId until visit returns false
+    int countBelow(LIGHTCOLOR color, STATE state, int id) const;//helper for countDrones, counts matching drones with smaller IDs
+    void recursiveClear(DroneBucket* aBucket);//helper for clear
+    DroneBucket* preOrderAssignment(const DroneBucket* rhsBucket);//helper for the assignment operator
+    void inorderList(const DroneBucket* curr) const;//helper for listDrones
+    void flattenInorder(DroneBucket* curr, vector<DroneBucket*>& buckets);//helper for removeIf
+    int loadRoster(vector<Drone>& roster);//helper for bulkLoad, does all of the work once the range is copied
+    void packBuckets(vector<DroneBucket*>& buckets, const vector<Drone>& drones, int fill);//helper for bulkLoad and removeIf, rebuilds the tree
+};
+
+//bulkLoad
+//copies the range into a roster, then sorts, dedupes, and rebuilds the buckets at once
+template <class Iterator>
+int BucketShow::bulkLoad(Iterator first, Iterator last){
+    vector<Drone> roster(first, last);
+    return loadRoster(roster);
+}
+
+//removeIf
+//lists the drones that are kept in order, then packs them into the existing buckets front to back and rebuilds a balanced tree
+template <class Predicate>
+int BucketShow::removeIf(Predicate shouldRemove){
+    vector<DroneBucket*> buckets;
+    flattenInorder(m_root, buckets);
+    vector<Drone> kept;
+    int numRemoved = 0;
+    for (unsigned int b = 0; b < buckets.size(); b++){
+        for (int i = 0; i < buckets[b]->m_numDrones; i++){
+            const Drone aDrone = buckets[b]->makeDrone(i);
+            if (shouldRemove(aDrone)){
+                numRemoved++;
+            }
+            else{
+                kept.push_back(aDrone);
+            }
+        }
+    }
+    packBuckets(buckets, kept, BUCKET_SIZE);
+    return numRemoved;
+}
+
+//walkFrom
+//stacks the buckets reaching loId or beyond on the way down, then visits in order until visit returns false
+//only the path to loId and the buckets visited are touched, so it costs O(log n + k)
+template <class Function>
+void BucketShow::walkFrom(int loId, Function visit) const{
+    const DroneBucket* stack[MAXDEPTH];
+    int depth = 0;
+    const DroneBucket* curr = m_root;
+    while (curr != nullptr){
+        if (curr->getMaxID() >= loId){
+            stack[depth++] = curr;
+            curr = curr->m_left;
+        }
+        else{
+            curr = curr->m_right;
+        }
+    }
+    while (depth > 0){
+        curr = stack[--depth];
+        for (int i = slotOf(curr, loId); i < curr->m_numDrones; i++){
+            if (!visit(curr->makeDrone(i))){
+                return;
+            }
+        }
+        for (curr = curr->m_right; curr != nullptr; curr = curr->m_left){
+            stack[depth++] = curr;
+        }
+    }
+}
+
+//forEachInRange
+//walks in order from loId until an ID passes hiId
+template <class Function>
+void BucketShow::forEachInRange(int loId, int hiId, Function visit) const{
+    walkFrom(loId, [&](const Drone& aDrone){
+        if (aDrone.getID() > hiId){
+            return false;
+        }
+        visit(aDrone);
+        return true;
+    });
+}
+#endif
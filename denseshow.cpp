@@ -0,0 +1,407 @@
+/***************************
+ ** File:    denseshow.cpp
+ ** Project: extension of CMSC 341, proj2, Spring 2023
+ ** Author:  Show maintainers, not part of the original project
+ ** Date:    10/17/2026
+ **
+ ** This file defines the functions laid out in denseshow.h, a Show stored as one byte per possible ID
+ ** and a two level bitset of the IDs in use
+ **
+*****************************/
+
+#include "denseshow.h"
+
+//Default constructor
+//Starts with no IDs in use
+DenseShow::DenseShow(){
+    clear();
+}
+
+//operator=
+//copies every array, avoids self assignment
+const DenseShow & DenseShow::operator=(const DenseShow & rhs){
+    if (this != &rhs){
+        for (int i = 0; i < NUMIDS; i++){
+            m_slots[i] = rhs.m_slots[i];
+        }
+        for (int i = 0; i < DENSE_WORDS; i++){
+            m_occupied[i] = rhs.m_occupied[i];
+        }
+        for (int i = 0; i < DENSE_SUMMARY; i++){
+            m_summary[i] = rhs.m_summary[i];
+        }
+        for (int i = 0; i < NUMCOLORS; i++){
+            for (int j = 0; j < NUMSTATES; j++){
+                m_counts[i][j] = rhs.m_counts[i][j];
+            }
+        }
+    }
+    return *this;
+}
+
+//insert
+//adds a new drone, reports whether it was inserted, a duplicate, or invalid
+INSERTRESULT DenseShow::insert(const Drone& aDrone){
+    return insert(aDrone.getID(), aDrone.getType(), aDrone.getState());
+}
+
+//insert
+//the drone's slot is written and its bit set, no search is needed
+INSERTRESULT DenseShow::insert(int id, LIGHTCOLOR type, STATE state){
+    //if statement checks to ensure that the ID, light color, and state are all valid
+    if (!inRange(id) || ((type != RED) && (type != GREEN) && (type != BLUE))
+        || ((state != LIGHTON) && (state != LIGHTOFF))){
+        return INVALID;
+    }
+    int pos = id - MINID;
+    if (isSet(pos)){
+        return DUPLICATE;
+    }
+    m_slots[pos] = encode(type, state);
+    setBit(pos);
+    m_counts[type][state]++;
+    return INSERTED;
+}
+
+//clear
+//only the bitsets and counts are reset, a slot is never read unless its bit is set
+void DenseShow::clear(){
+    for (int i = 0; i < DENSE_WORDS; i++){
+        m_occupied[i] = 0;
+    }
+    for (int i = 0; i < DENSE_SUMMARY; i++){
+        m_summary[i] = 0;
+    }
+    for (int i = 0; i < NUMCOLORS; i++){
+        for (int j = 0; j < NUMSTATES; j++){
+            m_counts[i][j] = 0;
+        }
+    }
+}
+
+//remove
+//clears the drone's bit, its slot is left behind and ignored
+REMOVERESULT DenseShow::remove(int id){
+    if (!findDrone(id)){
+        return ABSENT;
+    }
+    int pos = id - MINID;
+    m_counts[typeOf(m_slots[pos])][stateOf(m_slots[pos])]--;
+    clearBit(pos);
+    return REMOVED;
+}
+
+//dumpTree
+//there is no tree, so every run of consecutive IDs is printed as (first-last)
+void DenseShow::dumpTree() const{
+    int pos = nextSet(0);
+    while (pos != NO_DRONE){
+        int last = pos;
+        while ((last + 1 < NUMIDS) && isSet(last + 1)){
+            last++;
+        }
+        cout << "(" << pos + MINID << "-" << last + MINID << ")";
+        pos = nextSet(last + 1);
+    }
+}
+
+//listDrones
+//list all of the drones in order
+void DenseShow::listDrones() const{
+    if (countDrones() == 0){
+        cout << "Empty tree" << endl;
+    }
+    else{
+        for (int pos = nextSet(0); pos != NO_DRONE; pos = nextSet(pos + 1)){
+            Drone curr = makeDrone(pos);
+            cout << curr.getID() << ":" << curr.getStateStr() << ":" << curr.getTypeStr() << endl;
+        }
+    }
+}
+
+//setState
+//finds the ID, and changes the state
+bool DenseShow::setState(int id, STATE state){
+    //if statement checks to ensure the state is valid, the drone exists, and the states are different
+    if (((state != LIGHTON) && (state != LIGHTOFF)) || !findDrone(id)){
+        return false;
+    }
+    int pos = id - MINID;
+    LIGHTCOLOR type = typeOf(m_slots[pos]);
+    STATE oldState = stateOf(m_slots[pos]);
+    if (oldState == state){
+        return false;
+    }
+    m_counts[type][oldState]--;
+    m_counts[type][state]++;
+    m_slots[pos] = encode(type, state);
+    return true;
+}
+
+//removeLightOff
+//removes every drone that is LIGHTOFF
+void DenseShow::removeLightOff(){
+    removeIf([](const Drone& aDrone){return aDrone.getState() == LIGHTOFF;});
+}
+
+//findDrone
+//a single bit test
+bool DenseShow::findDrone(int id) const{
+    return inRange(id) && isSet(id - MINID);
+}
+
+//findDrones
+//each lookup is one bit test, so there are no descents to interleave
+void DenseShow::findDrones(const int ids[], int numIds, bool found[]) const{
+    for (int i = 0; i < numIds; i++){
+        found[i] = findDrone(ids[i]);
+    }
+}
+
+//setStates
+//applies each update in order, exactly as setState would
+void DenseShow::setStates(const pair<int, STATE> updates[], int numUpdates, bool changed[]){
+    for (int i = 0; i < numUpdates; i++){
+        changed[i] = setState(updates[i].first, updates[i].second);
+    }
+}
+
+//rank
+//popcounts the whole words below id, then the part of its own word below it
+int DenseShow::rank(int id) const{
+    if (id <= MINID){
+        return 0;
+    }
+    if (id > MAXID){
+        return countDrones();
+    }
+    int pos = id - MINID;
+    int count = 0;
+    for (int w = 0; w < (pos >> 6); w++){
+        count += __builtin_popcountll(m_occupied[w]);
+    }
+    if ((pos & 63) != 0){
+        count += __builtin_popcountll(m_occupied[pos >> 6] & ((uint64_t)-1 >> (64 - (pos & 63))));
+    }
+    return count;
+}
+
+//select
+//skips whole words by their popcounts, then clears the lowest bits of the word holding position k
+int DenseShow::select(int k) const{
+    if ((k < 0) || (k >= countDrones())){
+        return NO_DRONE;
+    }
+    for (int w = 0; w < DENSE_WORDS; w++){
+        int count = __builtin_popcountll(m_occupied[w]);
+        if (k < count){
+            uint64_t bits = m_occupied[w];
+            for (int i = 0; i < k; i++){
+                bits &= bits - 1;
+            }
+            return (w << 6) + __builtin_ctzll(bits) + MINID;
+        }
+        k -= count;
+    }
+    return NO_DRONE;
+}
+
+//listDrones
+//finds position offset with select, then copies drones in order from there
+int DenseShow::listDrones(int offset, int limit, Drone buffer[]) const{
+    if ((offset < 0) || (limit <= 0)){
+        return 0;
+    }
+    int id = select(offset);
+    int numCopied = 0;
+    for (int pos = ((id == NO_DRONE) ? NO_DRONE : id - MINID); (pos != NO_DRONE) && (numCopied < limit); pos = nextSet(pos + 1)){
+        buffer[numCopied++] = makeDrone(pos);
+    }
+    return numCopied;
+}
+
+//sampleDrone
+//picks a uniform position and selects it
+int DenseShow::sampleDrone(mt19937& generator) const{
+    if (countDrones() == 0){
+        return NO_DRONE;
+    }
+    uniform_int_distribution<int> position(0, countDrones() - 1);
+    return select(position(generator));
+}
+
+//floor
+//the last ID in use at or before id
+int DenseShow::floor(int id) const{
+    if (id < MINID){
+        return NO_DRONE;
+    }
+    int pos = prevSet((id > MAXID) ? NUMIDS - 1 : id - MINID);
+    return ((pos == NO_DRONE) ? NO_DRONE : pos + MINID);
+}
+
+//ceiling
+//the first ID in use at or after id
+int DenseShow::ceiling(int id) const{
+    if (id > MAXID){
+        return NO_DRONE;
+    }
+    int pos = nextSet((id < MINID) ? 0 : id - MINID);
+    return ((pos == NO_DRONE) ? NO_DRONE : pos + MINID);
+}
+
+//successor
+//the first ID in use after id
+int DenseShow::successor(int id) const{
+    return ((id >= MAXID) ? NO_DRONE : ceiling(id + 1));
+}
+
+//predecessor
+//the last ID in use before id
+int DenseShow::predecessor(int id) const{
+    return ((id <= MINID) ? NO_DRONE : floor(id - 1));
+}
+
+//removeRange
+//clears the bits in [loId, hiId] a word at a time, only the drones in range are decoded to fix the counts
+int DenseShow::removeRange(int loId, int hiId){
+    int loPos = ((loId < MINID) ? 0 : loId - MINID);
+    int hiPos = ((hiId > MAXID) ? NUMIDS - 1 : hiId - MINID);
+    int numRemoved = 0;
+    for (int pos = nextSet(loPos); (pos != NO_DRONE) && (pos <= hiPos); pos = nextSet(pos + 1)){
+        int w = pos >> 6;
+        //the bits of this word that are in range
+        uint64_t mask = (uint64_t)-1 << (pos & 63);
+        if ((hiPos >> 6) == w){
+            mask &= (uint64_t)-1 >> (63 - (hiPos & 63));
+        }
+        uint64_t bits = m_occupied[w] & mask;
+        numRemoved += __builtin_popcountll(bits);
+        for (uint64_t rest = bits; rest != 0; rest &= rest - 1){
+            unsigned char slot = m_slots[(w << 6) + __builtin_ctzll(rest)];
+            m_counts[typeOf(slot)][stateOf(slot)]--;
+        }
+        m_occupied[w] &= ~bits;
+        if (m_occupied[w] == 0){
+            m_summary[w >> 6] &= ~((uint64_t)1 << (w & 63));
+        }
+        pos = (w << 6) + 63;
+    }
+    return numRemoved;
+}
+
+//countDrones
+//the counts are kept up to date by every change, so each is read directly
+int DenseShow::countDrones() const{
+    int count = 0;
+    for (int i = 0; i < NUMCOLORS; i++){
+        count += m_counts[i][LIGHTON] + m_counts[i][LIGHTOFF];
+    }
+    return count;
+}
+int DenseShow::countDrones(LIGHTCOLOR aColor) const{
+    if ((aColor < RED) || (aColor > BLUE)){
+        return 0;
+    }
+    return m_counts[aColor][LIGHTON] + m_counts[aColor][LIGHTOFF];
+}
+int DenseShow::countDrones(STATE aState) const{
+    if ((aState < LIGHTON) || (aState > LIGHTOFF)){
+        return 0;
+    }
+    int count = 0;
+    for (int i = 0; i < NUMCOLORS; i++){
+        count += m_counts[i][aState];
+    }
+    return count;
+}
+
+//countDrones
+//the whole range is read from the counts, anything narrower walks the drones in range
+int DenseShow::countDrones(LIGHTCOLOR aColor, STATE aState, int loId, int hiId) const{
+    if ((aColor < RED) || (aColor > BLUE) || (aState < LIGHTON) || (aState > LIGHTOFF) || (loId > hiId)){
+        return 0;
+    }
+    if ((loId <= MINID) && (hiId >= MAXID)){
+        return m_counts[aColor][aState];
+    }
+    int count = 0;
+    unsigned char target = encode(aColor, aState);
+    forEachInRange(loId, hiId, [&](const Drone& aDrone){
+        count += (m_slots[aDrone.getID() - MINID] == target);
+    });
+    return count;
+}
+
+//freeze
+//the bitset already lists the IDs in order, so they are copied straight into the snapshot
+FrozenShow DenseShow::freeze() const{
+    vector<int> ids;
+    ids.reserve(countDrones());
+    for (int pos = nextSet(0); pos != NO_DRONE; pos = nextSet(pos + 1)){
+        ids.push_back(pos + MINID);
+    }
+    return FrozenShow(ids.data(), ids.size());
+}
+
+//setBit
+//marks pos, and marks its word in the summary
+void DenseShow::setBit(int pos){
+    int w = pos >> 6;
+    m_occupied[w] |= (uint64_t)1 << (pos & 63);
+    m_summary[w >> 6] |= (uint64_t)1 << (w & 63);
+}
+
+//clearBit
+//unmarks pos, and unmarks its word in the summary once nothing in it is in use
+void DenseShow::clearBit(int pos){
+    int w = pos >> 6;
+    m_occupied[w] &= ~((uint64_t)1 << (pos & 63));
+    if (m_occupied[w] == 0){
+        m_summary[w >> 6] &= ~((uint64_t)1 << (w & 63));
+    }
+}
+
+//nextSet
+//checks the rest of pos's word, then finds the next word in use through the summary
+int DenseShow::nextSet(int pos) const{
+    if ((pos < 0) || (pos >= NUMIDS)){
+        return NO_DRONE;
+    }
+    int w = pos >> 6;
+    uint64_t bits = m_occupied[w] & ((uint64_t)-1 << (pos & 63));
+    if (bits != 0){
+        return (w << 6) + __builtin_ctzll(bits);
+    }
+    //for loop scans the summary from the word after w
+    for (int next = w + 1; next < DENSE_WORDS; next = ((next >> 6) + 1) << 6){
+        uint64_t summary = m_summary[next >> 6] & ((uint64_t)-1 << (next & 63));
+        if (summary != 0){
+            int word = ((next >> 6) << 6) + __builtin_ctzll(summary);
+            return (word << 6) + __builtin_ctzll(m_occupied[word]);
+        }
+    }
+    return NO_DRONE;
+}
+
+//prevSet
+//checks the start of pos's word, then finds the previous word in use through the summary
+int DenseShow::prevSet(int pos) const{
+    if ((pos < 0) || (pos >= NUMIDS)){
+        return NO_DRONE;
+    }
+    int w = pos >> 6;
+    uint64_t bits = m_occupied[w] & ((uint64_t)-1 >> (63 - (pos & 63)));
+    if (bits != 0){
+        return (w << 6) + 63 - __builtin_clzll(bits);
+    }
+    //for loop scans the summary from the word before w
+    for (int prev = w - 1; prev >= 0; prev = ((prev >> 6) << 6) - 1){
+        uint64_t summary = m_summary[prev >> 6] & ((uint64_t)-1 >> (63 - (prev & 63)));
+        if (summary != 0){
+            int word = ((prev >> 6) << 6) + 63 - __builtin_clzll(summary);
+            return (word << 6) + 63 - __builtin_clzll(m_occupied[word]);
+        }
+    }
+    return NO_DRONE;
+}
@@ -0,0 +1,98 @@
+// Extension of UMBC - CMSC 341 - Spring 2023 - Proj2, added by the Show maintainers
+#ifndef DENSESHOW_H
+#define DENSESHOW_H
+#include "show.h"
+const int NUMIDS = MAXID - MINID + 1;//the number of possible drone IDs
+const int DENSE_WORDS = (NUMIDS + 63) / 64;//occupancy words, one bit per ID
+const int DENSE_SUMMARY = (DENSE_WORDS + 63) / 64;//summary words, one bit per occupancy word that is not empty
+//DenseShow
+//a Show for fleets that fill much of the ID range, every possible ID has its own byte indexed by id - MINID
+//a two level bitset of which IDs are in use gives ordered walks, and the next or previous drone in a few word scans
+//insert, remove, findDrone, and setState are O(1) and nothing is ever rebalanced
+//it has the same public functions as Show, except that navigation returns IDs since there are no Drone nodes
+class DenseShow{
+    public:
+    friend class Tester;
+    DenseShow();
+    const DenseShow & operator=(const DenseShow & rhs);
+    INSERTRESULT insert(const Drone& aDrone);
+    INSERTRESULT insert(int id, LIGHTCOLOR type = DEFAULT_LIGHT, STATE state = DEFAULT_STATE);
+    void clear();
+    REMOVERESULT remove(int id);
+    void dumpTree() const;//prints each run of consecutive IDs in use
+    void listDrones() const;
+    bool setState(int id, STATE state);
+    void removeLightOff();//removes all LIGHTOFF Drones
+    template <class Predicate>
+    int removeIf(Predicate shouldRemove);//removes every drone the predicate holds for, returns how many were removed
+    bool findDrone(int id) const;//returns true if the drone is in the show
+    void findDrones(const int ids[], int numIds, bool found[]) const;//batched findDrone
+    void setStates(const pair<int, STATE> updates[], int numUpdates, bool changed[]);//batched setState, applied in order
+    int rank(int id) const;//the number of drones with IDs less than id
+    int select(int k) const;//the ID at position k in ID order, counting from 0, NO_DRONE if out of range
+    int listDrones(int offset, int limit, Drone buffer[]) const;//copies up to limit drones starting at position offset, returns how many
+    int sampleDrone(mt19937& generator) const;//the ID of a uniformly random drone, NO_DRONE if the show is empty
+    int floor(int id) const;//the largest ID not above id, NO_DRONE if there is none
+    int ceiling(int id) const;//the smallest ID not below id, NO_DRONE if there is none
+    int successor(int id) const;//the smallest ID above id, NO_DRONE if there is none
+    int predecessor(int id) const;//the largest ID below id, NO_DRONE if there is none
+    template <class Function>
+    void forEachInRange(int loId, int hiId, Function visit) const;//calls visit on every drone with an ID in [loId, hiId], in order
+    int removeRange(int loId, int hiId);//removes every drone with an ID in [loId, hiId], returns how many were removed
+    int countDrones() const;//the number of drones in the show
+    int countDrones(LIGHTCOLOR aColor) const;
+    int countDrones(STATE aState) const;
+    int countDrones(LIGHTCOLOR aColor, STATE aState, int loId, int hiId) const;//counts matching drones with IDs in [loId, hiId]
+    FrozenShow freeze() const;//builds a read only snapshot for fast lookups in O(n), later changes do not reach it
+
+    private:
+    unsigned char m_slots[NUMIDS];//the color in the low two bits and the state above them, only meaningful where m_occupied is set
+    uint64_t m_occupied[DENSE_WORDS];//bit id - MINID is set if the drone is in the show
+    uint64_t m_summary[DENSE_SUMMARY];//bit w is set if m_occupied[w] is not zero
+    int m_counts[NUMCOLORS][NUMSTATES];//the number of drones of each color and state
+
+    static unsigned char encode(LIGHTCOLOR type, STATE state) {return type | (state << 2);}
+    static LIGHTCOLOR typeOf(unsigned char slot) {return static_cast<LIGHTCOLOR>(slot & 3);}
+    static STATE stateOf(unsigned char slot) {return static_cast<STATE>(slot >> 2);}
+    static bool inRange(int id) {return (id >= MINID) && (id <= MAXID);}
+    Drone makeDrone(int pos) const {return Drone(pos + MINID, typeOf(m_slots[pos]), stateOf(m_slots[pos]));}
+
+    // ***************************************************
+    // Any private helper functions must be delared here!
+    // ***************************************************
+
+    bool isSet(int pos) const {return (m_occupied[pos >> 6] >> (pos & 63)) & 1;}
+    void setBit(int pos); //helper for insert, marks pos and its word as in use
+    void clearBit(int pos); //helper for remove, unmarks pos, and its word once the word is empty
+    int nextSet(int pos) const; //helper for navigation, the first position at or after pos in use, NO_DRONE if none or pos is past the end
+    int prevSet(int pos) const; //helper for navigation, the last position at or before pos in use, NO_DRONE if none or pos is negative
+};
+
+//removeIf
+//walks every drone in order through the bitset, tests it, and clears the ones the predicate holds for
+template <class Predicate>
+int DenseShow::removeIf(Predicate shouldRemove){
+    int numRemoved = 0;
+    for (int pos = nextSet(0); pos != NO_DRONE; pos = nextSet(pos + 1)){
+        const Drone aDrone = makeDrone(pos);
+        if (shouldRemove(aDrone)){
+            m_counts[typeOf(m_slots[pos])][stateOf(m_slots[pos])]--;
+            clearBit(pos);
+            numRemoved++;
+        }
+    }
+    return numRemoved;
+}
+
+//forEachInRange
+//jumps from one drone in use to the next with nextSet, which skips empty stretches through the summary
+template <class Function>
+void DenseShow::forEachInRange(int loId, int hiId, Function visit) const{
+    int loPos = ((loId < MINID) ? 0 : loId - MINID);
+    int hiPos = ((hiId > MAXID) ? NUMIDS - 1 : hiId - MINID);
+    for (int pos = nextSet(loPos); (pos != NO_DRONE) && (pos <= hiPos); pos = nextSet(pos + 1)){
+        const Drone aDrone = makeDrone(pos);
+        visit(aDrone);
+    }
+}
+#endif
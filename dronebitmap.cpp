@@ -0,0 +1,249 @@
+/***************************
+ ** File:    dronebitmap.cpp
+ ** Project: extension of CMSC 341, proj2, Spring 2023
+ ** Author:  Show maintainers, not part of the original project
+ ** Date:    10/17/2026
+ **
+ ** This file defines the functions laid out in dronebitmap.h, a compressed set of drone IDs
+ ** used by Show as its color and state indexes
+ **
+*****************************/
+
+#include "dronebitmap.h"
+#include <algorithm>
+#include <iterator>
+
+//add
+//finds or makes the container for id's upper half, then adds the lower half to it
+bool DroneBitmap::add(int id){
+    uint16_t key = id >> 16;
+    uint16_t low = id & 0xFFFF;
+    BitmapContainer& container = m_containers[findOrInsert(key)];
+    if (container.isBitmap()){
+        uint64_t bit = (uint64_t)1 << (low & 63);
+        if (container.m_words[low >> 6] & bit){
+            return false;
+        }
+        container.m_words[low >> 6] |= bit;
+    }
+    else{
+        std::vector<uint16_t>::iterator spot = std::lower_bound(container.m_values.begin(), container.m_values.end(), low);
+        if ((spot != container.m_values.end()) && (*spot == low)){
+            return false;
+        }
+        container.m_values.insert(spot, low);
+    }
+    container.m_cardinality++;
+    m_cardinality++;
+    //if statement checks if the array has grown past the point where a bitmap is smaller
+    if (!container.isBitmap() && (container.m_cardinality > ARRAY_LIMIT)){
+        toBitmap(container);
+    }
+    return true;
+}
+
+//remove
+//takes the lower half out of its container, and drops the container once it is empty
+bool DroneBitmap::remove(int id){
+    uint16_t key = id >> 16;
+    uint16_t low = id & 0xFFFF;
+    int index = indexOf(key);
+    if ((index == (int)m_containers.size()) || (m_containers[index].m_key != key)){
+        return false;
+    }
+    BitmapContainer& container = m_containers[index];
+    if (container.isBitmap()){
+        uint64_t bit = (uint64_t)1 << (low & 63);
+        if (!(container.m_words[low >> 6] & bit)){
+            return false;
+        }
+        container.m_words[low >> 6] &= ~bit;
+    }
+    else{
+        std::vector<uint16_t>::iterator spot = std::lower_bound(container.m_values.begin(), container.m_values.end(), low);
+        if ((spot == container.m_values.end()) || (*spot != low)){
+            return false;
+        }
+        container.m_values.erase(spot);
+    }
+    container.m_cardinality--;
+    m_cardinality--;
+    if (container.m_cardinality == 0){
+        m_containers.erase(m_containers.begin() + index);
+    }
+    //else if the bitmap has shrunk well below the limit, it goes back to an array
+    //the gap below ARRAY_LIMIT keeps a container near the limit from switching back and forth
+    else if (container.isBitmap() && (container.m_cardinality < ARRAY_LIMIT / 2)){
+        toArray(container);
+    }
+    return true;
+}
+
+//moveRange
+//walks this set's containers for the keys in range, each moving its lower halves in range to the matching container of to
+//the work is one merge or one pass over the words per container, however many IDs move
+void DroneBitmap::moveRange(DroneBitmap& to, int loId, int hiId){
+    if ((&to == this) || (hiId < 0) || (loId > hiId)){
+        return;
+    }
+    if (loId < 0){
+        loId = 0;
+    }
+    int index = indexOf(loId >> 16);
+    while ((index < (int)m_containers.size()) && (m_containers[index].m_key <= (hiId >> 16))){
+        BitmapContainer& from = m_containers[index];
+        int high = (int)from.m_key << 16;
+        int toIndex = to.findOrInsert(from.m_key);
+        BitmapContainer& target = to.m_containers[toIndex];
+        int fromBefore = from.m_cardinality;
+        int targetBefore = target.m_cardinality;
+        moveLows(from, target, ((loId > high) ? loId - high : 0), ((hiId - high < 0xFFFF) ? hiId - high : 0xFFFF));
+        m_cardinality += from.m_cardinality - fromBefore;
+        to.m_cardinality += target.m_cardinality - targetBefore;
+        if (target.m_cardinality == 0){
+            to.m_containers.erase(to.m_containers.begin() + toIndex);
+        }
+        if (from.m_cardinality == 0){
+            m_containers.erase(m_containers.begin() + index);
+        }
+        else{
+            index++;
+        }
+    }
+}
+
+//contains
+//one binary search of the containers, then one search or bit test inside
+bool DroneBitmap::contains(int id) const{
+    uint16_t key = id >> 16;
+    int index = indexOf(key);
+    return (index < (int)m_containers.size()) && (m_containers[index].m_key == key)
+           && m_containers[index].contains(id & 0xFFFF);
+}
+
+//clear
+//drops every container
+void DroneBitmap::clear(){
+    m_containers.clear();
+    m_cardinality = 0;
+}
+
+//contains
+//a bit test for a bitmap, a binary search for an array
+bool DroneBitmap::BitmapContainer::contains(uint16_t low) const{
+    if (isBitmap()){
+        return (m_words[low >> 6] >> (low & 63)) & 1;
+    }
+    return std::binary_search(m_values.begin(), m_values.end(), low);
+}
+
+//indexOf
+//binary search over the container keys
+int DroneBitmap::indexOf(uint16_t key) const{
+    int lo = 0;
+    int hi = m_containers.size();
+    while (lo < hi){
+        int mid = (lo + hi) / 2;
+        if (m_containers[mid].m_key < key){
+            lo = mid + 1;
+        }
+        else{
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+//findOrInsert
+//if statement checks if there is no container for key yet, in which case one is made in its place
+int DroneBitmap::findOrInsert(uint16_t key){
+    int index = indexOf(key);
+    if ((index == (int)m_containers.size()) || (m_containers[index].m_key != key)){
+        BitmapContainer container;
+        container.m_key = key;
+        container.m_cardinality = 0;
+        m_containers.insert(m_containers.begin() + index, container);
+    }
+    return index;
+}
+
+//moveLows
+//an array's lower halves in range are one run, which is merged into to and then erased
+//a bitmap's are masked out of each word in range and or'ed into to, which becomes a bitmap for the move
+//either side then switches form if its size crossed the same limits add and remove use
+void DroneBitmap::moveLows(BitmapContainer& from, BitmapContainer& to, int lo, int hi){
+    if (!from.isBitmap()){
+        std::vector<uint16_t>::iterator first = std::lower_bound(from.m_values.begin(), from.m_values.end(), lo);
+        std::vector<uint16_t>::iterator last = std::upper_bound(first, from.m_values.end(), hi);
+        if (first == last){
+            return;
+        }
+        if (to.isBitmap()){
+            for (std::vector<uint16_t>::iterator curr = first; curr != last; ++curr){
+                uint64_t bit = (uint64_t)1 << (*curr & 63);
+                to.m_cardinality += !(to.m_words[*curr >> 6] & bit);
+                to.m_words[*curr >> 6] |= bit;
+            }
+        }
+        else{
+            std::vector<uint16_t> merged;
+            merged.reserve(to.m_values.size() + (last - first));
+            std::set_union(to.m_values.begin(), to.m_values.end(), first, last, std::back_inserter(merged));
+            to.m_values.swap(merged);
+            to.m_cardinality = to.m_values.size();
+            if (to.m_cardinality > ARRAY_LIMIT){
+                toBitmap(to);
+            }
+        }
+        from.m_cardinality -= last - first;
+        from.m_values.erase(first, last);
+        return;
+    }
+    bool wasBitmap = to.isBitmap();
+    if (!wasBitmap){
+        toBitmap(to);
+    }
+    for (int w = lo >> 6; w <= (hi >> 6); w++){
+        uint64_t mask = ~(uint64_t)0;
+        if (w == (lo >> 6)){
+            mask &= ~(uint64_t)0 << (lo & 63);
+        }
+        if (w == (hi >> 6)){
+            mask &= ~(uint64_t)0 >> (63 - (hi & 63));
+        }
+        uint64_t bits = from.m_words[w] & mask;
+        from.m_words[w] &= ~mask;
+        from.m_cardinality -= __builtin_popcountll(bits);
+        to.m_cardinality += __builtin_popcountll(bits & ~to.m_words[w]);
+        to.m_words[w] |= bits;
+    }
+    if (from.m_cardinality < ARRAY_LIMIT / 2){
+        toArray(from);
+    }
+    if (!wasBitmap && (to.m_cardinality <= ARRAY_LIMIT)){
+        toArray(to);
+    }
+}
+
+//toBitmap
+//sets one bit per value, then frees the array
+void DroneBitmap::toBitmap(BitmapContainer& container){
+    container.m_words.assign(CONTAINER_WORDS, 0);
+    for (unsigned int i = 0; i < container.m_values.size(); i++){
+        container.m_words[container.m_values[i] >> 6] |= (uint64_t)1 << (container.m_values[i] & 63);
+    }
+    std::vector<uint16_t>().swap(container.m_values);
+}
+
+//toArray
+//lists the set bits in order, then frees the bitmap
+void DroneBitmap::toArray(BitmapContainer& container){
+    container.m_values.clear();
+    container.m_values.reserve(container.m_cardinality);
+    for (int w = 0; w < CONTAINER_WORDS; w++){
+        for (uint64_t bits = container.m_words[w]; bits != 0; bits &= bits - 1){
+            container.m_values.push_back((w << 6) + __builtin_ctzll(bits));
+        }
+    }
+    std::vector<uint64_t>().swap(container.m_words);
+}
@@ -0,0 +1,119 @@
+// Extension of UMBC - CMSC 341 - Spring 2023 - Proj2, added by the Show maintainers
+#ifndef DRONEBITMAP_H
+#define DRONEBITMAP_H
+#include <cstdint>
+#include <vector>
+class Tester;
+const int ARRAY_LIMIT = 4096;//a container holding more IDs than this switches to a bitmap
+const int CONTAINER_WORDS = 1024;//the words in a bitmap container, one bit for each of 65536 low halves
+//DroneBitmap
+//compressed set of drone IDs in the roaring style, IDs are grouped into containers by their upper 16 bits
+//a sparse container is a sorted array of the lower halves, a dense one is a 65536 bit bitmap
+//so memory follows the number of IDs, and sets are intersected a container at a time
+class DroneBitmap{
+    public:
+    friend class Tester;
+    DroneBitmap() : m_cardinality(0) {}
+    bool add(int id);//returns true if id was not already in the set
+    bool remove(int id);//returns true if id was in the set
+    bool contains(int id) const;
+    int cardinality() const {return m_cardinality;}
+    void clear();
+    void moveRange(DroneBitmap& to, int loId, int hiId);//moves every ID in [loId, hiId] into to, a container at a time
+    template <class Function>
+    void forEach(Function visit) const;//calls visit on every ID in increasing order
+    template <class Function>
+    static void forEachIntersection(const DroneBitmap& lhs, const DroneBitmap& rhs, Function visit);//calls visit on every ID in both, in increasing order
+
+    private:
+    //BitmapContainer
+    //the IDs sharing one upper half, held in values while sparse and in words once dense
+    class BitmapContainer{
+        public:
+        uint16_t m_key;//the upper 16 bits shared by every ID in the container
+        int m_cardinality;//the number of IDs in the container
+        std::vector<uint16_t> m_values;//the lower halves in increasing order, empty while words is used
+        std::vector<uint64_t> m_words;//one bit per lower half, empty while values is used
+        bool isBitmap() const {return !m_words.empty();}
+        bool contains(uint16_t low) const;
+        template <class Function>
+        void forEach(Function visit) const;
+    };
+    std::vector<BitmapContainer> m_containers;//in increasing order of key
+    int m_cardinality;//the number of IDs in the set
+
+    int indexOf(uint16_t key) const;//helper for lookups, the position of the first container whose key is not below key
+    int findOrInsert(uint16_t key);//helper for add and moveRange, the position of key's container, made empty if it was missing
+    static void moveLows(BitmapContainer& from, BitmapContainer& to, int lo, int hi);//helper for moveRange, moves the lower halves in [lo, hi]
+    static void toBitmap(BitmapContainer& container);//helper for add, switches a container that grew too large to a bitmap
+    static void toArray(BitmapContainer& container);//helper for remove, switches a container that shrank enough back to an array
+};
+
+//forEach
+//visits the container's lower halves in order, with its key in front of each
+template <class Function>
+void DroneBitmap::BitmapContainer::forEach(Function visit) const{
+    int high = (int)m_key << 16;
+    if (isBitmap()){
+        for (int w = 0; w < CONTAINER_WORDS; w++){
+            for (uint64_t bits = m_words[w]; bits != 0; bits &= bits - 1){
+                visit(high | ((w << 6) + __builtin_ctzll(bits)));
+            }
+        }
+    }
+    else{
+        for (unsigned int i = 0; i < m_values.size(); i++){
+            visit(high | m_values[i]);
+        }
+    }
+}
+
+//forEach
+//visits each container in order of key
+template <class Function>
+void DroneBitmap::forEach(Function visit) const{
+    for (unsigned int i = 0; i < m_containers.size(); i++){
+        m_containers[i].forEach(visit);
+    }
+}
+
+//forEachIntersection
+//walks both lists of containers together, and only intersects containers with the same key
+//two bitmaps are intersected a word at a time, otherwise the smaller side is walked and tested against the other
+template <class Function>
+void DroneBitmap::forEachIntersection(const DroneBitmap& lhs, const DroneBitmap& rhs, Function visit){
+    unsigned int i = 0;
+    unsigned int j = 0;
+    while ((i < lhs.m_containers.size()) && (j < rhs.m_containers.size())){
+        const BitmapContainer& left = lhs.m_containers[i];
+        const BitmapContainer& right = rhs.m_containers[j];
+        if (left.m_key < right.m_key){
+            i++;
+            continue;
+        }
+        if (right.m_key < left.m_key){
+            j++;
+            continue;
+        }
+        int high = (int)left.m_key << 16;
+        if (left.isBitmap() && right.isBitmap()){
+            for (int w = 0; w < CONTAINER_WORDS; w++){
+                for (uint64_t bits = left.m_words[w] & right.m_words[w]; bits != 0; bits &= bits - 1){
+                    visit(high | ((w << 6) + __builtin_ctzll(bits)));
+                }
+            }
+        }
+        else{
+            const BitmapContainer& smaller = ((left.m_cardinality <= right.m_cardinality) ? left : right);
+            const BitmapContainer& larger = ((left.m_cardinality <= right.m_cardinality) ? right : left);
+            smaller.forEach([&](int id){
+                if (larger.contains(id & 0xFFFF)){
+                    visit(id);
+                }
+            });
+        }
+        i++;
+        j++;
+    }
+}
+#endif
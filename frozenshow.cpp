@@ -0,0 +1,142 @@
+/***************************
+ ** File:    frozenshow.cpp
+ ** Project: extension of CMSC 341, proj2, Spring 2023
+ ** Author:  Show maintainers, not part of the original project
+ ** Date:    10/17/2026
+ **
+ ** This file defines the functions laid out in frozenshow.h, a read only snapshot of a Show
+ ** which answers membership with branchless, prefetching searches over one array
+ **
+*****************************/
+
+#include "frozenshow.h"
+#include "show.h"
+#include <cstdlib>
+#include <cstring>
+
+const int CACHE_LINE = 64;//bytes in a cache line, the keys are aligned to it
+const int PREFETCH_STRIDE = 16;//the number of keys in a cache line, node k's descendants four levels down start at 16k
+const int PADDING_ID = MAXID + 1;//fills the slots past the real IDs, larger than any ID so searches never stop on one
+
+//Default constructor
+//an empty snapshot still has one padding slot, so searches need no special case
+FrozenShow::FrozenShow(){
+    allocate(1);
+    m_keys[1] = PADDING_ID;
+    m_numIds = 0;
+}
+
+//constructor
+//lays the sorted IDs out in Eytzinger order, padding the end up to a complete tree
+FrozenShow::FrozenShow(const int sortedIds[], int numIds){
+    int capacity = 1;
+    //while loop finds the smallest complete tree holding every ID
+    while (capacity < numIds){
+        capacity = 2 * capacity + 1;
+    }
+    allocate(capacity);
+    m_numIds = numIds;
+
+    //the padding is placed after the real IDs, so the whole array is still in order
+    int* padded = new int[capacity];
+    for (int i = 0; i < capacity; i++){
+        padded[i] = ((i < numIds) ? sortedIds[i] : PADDING_ID);
+    }
+    int next = 0;
+    fill(padded, next, 1);
+    delete [] padded;
+}
+
+//copy constructor
+FrozenShow::FrozenShow(const FrozenShow& rhs){
+    allocate(rhs.m_capacity);
+    memcpy(m_keys, rhs.m_keys, (m_capacity + 1) * sizeof(int));
+    m_numIds = rhs.m_numIds;
+}
+
+//Destructor
+FrozenShow::~FrozenShow(){
+    free(m_keys);
+}
+
+//operator=
+//assigns an rhs to another, avoids self assignment
+const FrozenShow & FrozenShow::operator=(const FrozenShow & rhs){
+    if (this != &rhs){
+        free(m_keys);
+        allocate(rhs.m_capacity);
+        memcpy(m_keys, rhs.m_keys, (m_capacity + 1) * sizeof(int));
+        m_numIds = rhs.m_numIds;
+    }
+    return *this;
+}
+
+//contains
+//descends one level per step by turning the comparison into the next index, so there is no branch to mispredict
+//the line holding the node four levels down is prefetched on the way, since it is the next one missed
+bool FrozenShow::contains(int id) const{
+    unsigned int k = 1;
+    for (int level = 0; level < m_levels; level++){
+        __builtin_prefetch(m_keys + ((PREFETCH_STRIDE * k <= (unsigned int)m_capacity) ? PREFETCH_STRIDE * k : 0));
+        k = 2 * k + (m_keys[k] < id);
+    }
+    //the right turns taken after the last left turn are undone, which leaves the first key not below id
+    k >>= __builtin_ffs(~k);
+    return (k != 0) && (m_keys[k] == id) && (id >= MINID) && (id <= MAXID);
+}
+
+//contains
+//runs BATCH_LANES searches in lockstep, so the cache misses of different lookups overlap instead of queueing
+void FrozenShow::contains(const int ids[], int numIds, uint64_t found[]) const{
+    for (int i = 0; i < (numIds + 63) / 64; i++){
+        found[i] = 0;
+    }
+    for (int start = 0; start < numIds; start += BATCH_LANES){
+        int numLanes = ((numIds - start < BATCH_LANES) ? numIds - start : BATCH_LANES);
+        unsigned int k[BATCH_LANES];
+        int target[BATCH_LANES];
+        //unused lanes search for the padding, which is harmless and keeps every loop the same length
+        for (int lane = 0; lane < BATCH_LANES; lane++){
+            k[lane] = 1;
+            target[lane] = ((lane < numLanes) ? ids[start + lane] : PADDING_ID);
+        }
+        for (int level = 0; level < m_levels; level++){
+            for (int lane = 0; lane < BATCH_LANES; lane++){
+                k[lane] = 2 * k[lane] + (m_keys[k[lane]] < target[lane]);
+            }
+            for (int lane = 0; lane < BATCH_LANES; lane++){
+                __builtin_prefetch(m_keys + ((PREFETCH_STRIDE * k[lane] <= (unsigned int)m_capacity) ? PREFETCH_STRIDE * k[lane] : 0));
+            }
+        }
+        for (int lane = 0; lane < numLanes; lane++){
+            unsigned int bound = k[lane] >> __builtin_ffs(~k[lane]);
+            int id = target[lane];
+            uint64_t hit = (bound != 0) && (m_keys[bound] == id) && (id >= MINID) && (id <= MAXID);
+            found[(start + lane) / 64] |= hit << ((start + lane) % 64);
+        }
+    }
+}
+
+//allocate
+//allocates slots 0 through capacity, aligned so that slot 16k starts a cache line
+void FrozenShow::allocate(int capacity){
+    m_capacity = capacity;
+    m_levels = 0;
+    for (int nodes = capacity; nodes > 0; nodes /= 2){
+        m_levels++;
+    }
+    int bytes = (capacity + 1) * sizeof(int);
+    bytes = ((bytes + CACHE_LINE - 1) / CACHE_LINE) * CACHE_LINE;
+    m_keys = static_cast<int*>(aligned_alloc(CACHE_LINE, bytes));
+    m_keys[0] = PADDING_ID;
+}
+
+//fill
+//in order traversal of the implicit tree, which hands out the sorted IDs smallest first
+void FrozenShow::fill(const int sortedIds[], int& next, int k){
+    if (k <= m_capacity){
+        fill(sortedIds, next, 2 * k);
+        m_keys[k] = sortedIds[next++];
+        fill(sortedIds, next, 2 * k + 1);
+    }
+}
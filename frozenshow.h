@@ -0,0 +1,32 @@
+// Extension of UMBC - CMSC 341 - Spring 2023 - Proj2, added by the Show maintainers
+#ifndef FROZENSHOW_H
+#define FROZENSHOW_H
+#include <cstdint>
+class Tester;
+const int BATCH_LANES = 8;//the number of lookups contains runs side by side in a batch
+//FrozenShow
+//read only snapshot of the drone IDs in a Show, laid out in Eytzinger (breadth first) order
+//node k has its children at 2k and 2k + 1, so a search only moves forward through one array
+//the array is padded to a complete tree, which lets every search take the same number of steps
+class FrozenShow{
+    public:
+    friend class Tester;
+    FrozenShow();
+    FrozenShow(const int sortedIds[], int numIds);//builds the snapshot in O(n) from IDs in increasing order
+    FrozenShow(const FrozenShow& rhs);
+    ~FrozenShow();
+    const FrozenShow & operator=(const FrozenShow & rhs);
+    bool contains(int id) const;//branchless search, true if the drone is in the snapshot
+    void contains(const int ids[], int numIds, uint64_t found[]) const;//sets bit i % 64 of found[i / 64] if ids[i] is in the snapshot
+    int size() const {return m_numIds;}
+
+    private:
+    int* m_keys;//the IDs in Eytzinger order starting at index 1, aligned to a cache line
+    int m_capacity;//the number of slots after index 0, always one less than a power of two
+    int m_levels;//the number of levels in the complete tree
+    int m_numIds;//the number of real IDs, the rest of the slots are padding
+
+    void allocate(int capacity);//helper for the constructors, allocates aligned storage
+    void fill(const int sortedIds[], int& next, int k);//helper for the constructor, fills the tree in order
+};
+#endif
@@ -9,12 +9,17 @@
  ** This file is written as a test for show.cpp. Numerous cases are tested to ensure
  ** that the code works properly. Normal cases, edge cases, and error cases are tested, alongside
  ** other tests such as testing the assignment operator, inserting and removing nodes, and removing all drones with lights off
+ ** The test blocks after the original ones were added later by the Show maintainers, alongside the features they cover
  **
 *****************************/
 
 #include "show.h"
+#include "bucketshow.h"
+#include "denseshow.h"
 #include <random>
 #include <cmath> //cmath included for large insertion and deletion
+#include <algorithm> //algorithm included to test the iterators
+#include <map> //map included to check the tree core against
 
 //global constants
 const int MAX_SIZE = 90000; //MAX_SIZE is the highest possible number of drones one can have in a tree
@@ -131,6 +136,31 @@ class Tester{
         //testing of other functions
         bool testRemoveLightOff(Show& show);
         bool testCountDrones(Show& show);
+        bool testMutationResults(Show& show);
+        bool testPool(Show& show);
+        bool testBulkLoad(Show& show);
+        bool testRemoveIf(Show& show);
+        bool testSubtreeCounts(Show& show);
+        bool testOrderStatistics(Show& show);
+        bool testOrderedNavigation(Show& show);
+        bool testIterators(Show& show);
+        bool testCompactDrone(Show& show);
+        bool testFreeze(Show& show);
+        bool testBatchedLookups(Show& show);
+        bool testBucketShow(Show& show);
+        bool testDenseShow(Show& show);
+        bool testIndexes(Show& show);
+        bool testCompact(Show& show);
+        bool testInlineMode(Show& show);
+        bool testTreeCore(Show& show);
+        bool testWavl(Show& show);
+        bool testAdaptive(Show& show);
+        bool testHotCache(Show& show);
+        bool testRotationKernels(Show& show);
+        bool testBurst(Show& show);
+        bool testFingerInsert(Show& show);
+        bool testRangeUpdates(Show& show);
+        bool testBatchApply(Show& show);
 
         //miscellaneous helper functions
         bool randomFill(Show& show); //helper which helps to fill tests
@@ -145,6 +175,11 @@ class Tester{
         
         bool removeLightHelper(bool result, const Drone* curr); //helper for testRemoveLightOff
         bool assignmentHelper(bool result, const Drone* lhsPtr, const Drone* rhsPtr); //helper for testAssignment and errorAssignment
+        bool countHelper(const Drone* curr); //helper for testSubtreeCounts, checks every drone's counters against its children
+        bool balanceHelper(const Drone* curr, int slack = 1); //helper for range and join tests, checks that every drone's children are within slack in height
+        bool bucketHelper(const DroneBucket* curr, int& prevID); //helper for testBucketShow, checks bucket order, heights, balance, and counts
+        bool rankHelper(const Drone* curr); //helper for testWavl, checks that every drone keeps the WAVL rank rules
+        Drone* referenceRestructure(Drone* zDrone); //helper for testRotationKernels, the generic trinode restructure the kernels replaced
 };
 
 int main(){
@@ -531,6 +566,356 @@ int main(){
         delete newShow;
         cout << "\n***END TEST BLOCK TWENTY ONE ***" << endl;
     } 
+    {
+        cout << "\n*** TEST BLOCK TWENTY TWO ***" << endl << endl;
+        cout << "This will test to ensure that insert and remove report what happened" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //insert and remove results tested 
+        cout << "Testing insert and remove results: \n\t";
+        bool testResult = tester.testMutationResults(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK TWENTY TWO ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK TWENTY THREE ***" << endl << endl;
+        cout << "This will test to ensure that drones are pooled and recycled" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testPool tested 
+        cout << "Testing the drone pool: \n\t";
+        bool testResult = tester.testPool(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK TWENTY THREE ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK TWENTY FOUR ***" << endl << endl;
+        cout << "This will test to ensure that bulkLoad builds a balanced tree" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testBulkLoad tested 
+        cout << "Testing bulkLoad: \n\t";
+        bool testResult = tester.testBulkLoad(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK TWENTY FOUR ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK TWENTY FIVE ***" << endl << endl;
+        cout << "This will test to ensure that removeIf removes drones in one pass" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testRemoveIf tested 
+        cout << "Testing removeIf: \n\t";
+        bool testResult = tester.testRemoveIf(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK TWENTY FIVE ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK TWENTY SIX ***" << endl << endl;
+        cout << "This will test to ensure that the subtree counters stay correct" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testSubtreeCounts tested 
+        cout << "Testing subtree counts: \n\t";
+        bool testResult = tester.testSubtreeCounts(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK TWENTY SIX ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK TWENTY SEVEN ***" << endl << endl;
+        cout << "This will test to ensure that rank, select, paging, and sampling work" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testOrderStatistics tested 
+        cout << "Testing order statistics: \n\t";
+        bool testResult = tester.testOrderStatistics(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK TWENTY SEVEN ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK TWENTY EIGHT ***" << endl << endl;
+        cout << "This will test to ensure that ordered navigation and removeRange work" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testOrderedNavigation tested 
+        cout << "Testing ordered navigation: \n\t";
+        bool testResult = tester.testOrderedNavigation(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK TWENTY EIGHT ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK TWENTY NINE ***" << endl << endl;
+        cout << "This will test to ensure that iterators walk the tree in order" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testIterators tested 
+        cout << "Testing iterators: \n\t";
+        bool testResult = tester.testIterators(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK TWENTY NINE ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK THIRTY ***" << endl << endl;
+        cout << "This will test to ensure that the compact drone layout is lossless" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testCompactDrone tested 
+        cout << "Testing the compact drone layout: \n\t";
+        bool testResult = tester.testCompactDrone(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK THIRTY ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK THIRTY ONE ***" << endl << endl;
+        cout << "This will test to ensure that frozen snapshots answer lookups correctly" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testFreeze tested 
+        cout << "Testing freeze: \n\t";
+        bool testResult = tester.testFreeze(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK THIRTY ONE ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK THIRTY TWO ***" << endl << endl;
+        cout << "This will test to ensure that batched lookups and state changes are correct" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testBatchedLookups tested 
+        cout << "Testing batched lookups: \n\t";
+        bool testResult = tester.testBatchedLookups(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK THIRTY TWO ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK THIRTY THREE ***" << endl << endl;
+        cout << "This will test to ensure that the bucketed tree matches the drone tree" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testBucketShow tested 
+        cout << "Testing the bucketed tree: \n\t";
+        bool testResult = tester.testBucketShow(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK THIRTY THREE ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK THIRTY FOUR ***" << endl << endl;
+        cout << "This will test to ensure that the dense show matches the drone tree" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testDenseShow tested 
+        cout << "Testing the dense show: \n\t";
+        bool testResult = tester.testDenseShow(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK THIRTY FOUR ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK THIRTY FIVE ***" << endl << endl;
+        cout << "This will test to ensure that the color and state indexes stay correct" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testIndexes tested 
+        cout << "Testing the indexes: \n\t";
+        bool testResult = tester.testIndexes(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK THIRTY FIVE ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK THIRTY SIX ***" << endl << endl;
+        cout << "This will test to ensure that compact relocates drones without changing the tree" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testCompact tested 
+        cout << "Testing compact: \n\t";
+        bool testResult = tester.testCompact(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK THIRTY SIX ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK THIRTY SEVEN ***" << endl << endl;
+        cout << "This will test to ensure that small shows kept inline behave like any other" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testInlineMode tested 
+        cout << "Testing inline mode: \n\t";
+        bool testResult = tester.testInlineMode(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK THIRTY SEVEN ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK THIRTY EIGHT ***" << endl << endl;
+        cout << "Tests the generic tree core against std::map" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testTreeCore tested 
+        cout << "Tree core: \n\t";
+        bool testResult = tester.testTreeCore(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK THIRTY EIGHT ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK THIRTY NINE ***" << endl << endl;
+        cout << "Tests WAVL balancing against AVL under churn" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testWavl tested 
+        cout << "WAVL balancing: \n\t";
+        bool testResult = tester.testWavl(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK THIRTY NINE ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK FORTY ***" << endl << endl;
+        cout << "Tests the adaptive mode on a Zipfian trace" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testAdaptive tested 
+        cout << "Adaptive balancing: \n\t";
+        bool testResult = tester.testAdaptive(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK FORTY ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK FORTY ONE ***" << endl << endl;
+        cout << "Tests the hot ID cache in front of findDrone and setState" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testHotCache tested 
+        cout << "Hot ID cache: \n\t";
+        bool testResult = tester.testHotCache(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK FORTY ONE ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK FORTY TWO ***" << endl << endl;
+        cout << "Tests the direct rotation kernels against the generic restructure" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testRotationKernels tested 
+        cout << "Rotation kernels: \n\t";
+        bool testResult = tester.testRotationKernels(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK FORTY TWO ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK FORTY THREE ***" << endl << endl;
+        cout << "Tests deferred rebalancing during a burst of changes" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testBurst tested 
+        cout << "Burst: \n\t";
+        bool testResult = tester.testBurst(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK FORTY THREE ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK FORTY FOUR ***" << endl << endl;
+        cout << "Tests finger appends at both ends and hinted inserts" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testFingerInsert tested 
+        cout << "Finger insert: \n\t";
+        bool testResult = tester.testFingerInsert(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK FORTY FOUR ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK FORTY FIVE ***" << endl << endl;
+        cout << "Tests lazy range updates and recolors" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testRangeUpdates tested 
+        cout << "Range updates: \n\t";
+        bool testResult = tester.testRangeUpdates(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK FORTY FIVE ***" << endl;
+    }
+    {
+        cout << "\n*** TEST BLOCK FORTY SIX ***" << endl << endl;
+        cout << "Tests batched inserts, removes, and state changes" << endl << endl;
+        
+        newShow = new Show(); //show initialized
+
+        //testBatchApply tested 
+        cout << "Batch apply: \n\t";
+        bool testResult = tester.testBatchApply(*newShow);
+        tester.testCondition(testResult);
+
+        delete newShow;
+        cout << "\n***END TEST BLOCK FORTY SIX ***" << endl;
+    }
     cout << "\n**********************" << endl;
     cout << "***** END TEST *******" << endl;
     cout << "**********************" << endl;
@@ -1713,58 +2098,2209 @@ bool Tester::testCountDrones(Show& show){
     return result;
 }
 
-//randomFill
-//copied from driver, fills show with 15 random elements
-bool Tester::randomFill(Show& show){
+//testMutationResults
+//tests that insert and remove return the correct result for each outcome
+bool Tester::testMutationResults(Show& show){
     bool result = true;
-    Random idGen(MINID,MAXID);
-    Random typeGen(0,2); // there are three colors
-    int ID = 0;
-    for(int i = 0; i < NORMAL_CASE; i++){
-        ID = idGen.getRandNum();
-        Drone drone(ID,static_cast<LIGHTCOLOR>(typeGen.getRandNum()));
-        show.insert(drone);
-        result = result && (show.findDrone(ID));
-    }
 
-    return result; 
-}
+    //checks to ensure tree is empty
+    result = result && (show.m_root == nullptr);
 
-//time complexity helper functions
+    //normal inserts are reported as inserted, and the tree stays balanced
+    for (int i = 0; i < 127; i++){
+        result = result && (show.insert(MINID + i, BLUE, LIGHTON) == INSERTED);
+    }
+    result = result && (checkHeight(show.m_root) == 6);
+    result = result && binarySearchTest(result, show.m_root);
 
-//insertTimeMeasurement
-//displays the time complexity of insertion
-double Tester::insertTimeMeasurement(Show& show, int addDrones){
-    double T = 0.0;//stores running times
-    clock_t start, stop;//stores the clock ticks while running the program
-    Random idGen(MINID,MAXID);
-    int ID;
+    //duplicates are reported and change nothing, whether inserted by ID or by drone
+    result = result && (show.insert(MINID, RED, LIGHTOFF) == DUPLICATE);
+    Drone myDrone(MINID + 50, GREEN);
+    result = result && (show.insert(myDrone) == DUPLICATE);
+    result = result && (show.countDrones(BLUE) == 127);
+
+    //invalid IDs, colors, and states are all reported as invalid
+    result = result && (show.insert(MINID - 1) == INVALID);
+    result = result && (show.insert(MAXID + 1) == INVALID);
+    result = result && (show.insert(50000, static_cast<LIGHTCOLOR>(3)) == INVALID);
+    result = result && (show.insert(50000, RED, static_cast<STATE>(2)) == INVALID);
+    result = result && !(show.findDrone(50000));
 
-    start = clock();
-    // the algorithm to be measured
-    //inserts the drones into the show
-    for (int i = 0; i < addDrones; i++){
-        ID = idGen.getRandNum();
-        Drone drone(ID);
-        show.insert(drone);
+    //removal is reported, and removing again reports the drone as absent
+    for (int i = 0; i < 127; i += 2){
+        result = result && (show.remove(MINID + i) == REMOVED);
+        result = result && (show.remove(MINID + i) == ABSENT);
     }
-    stop = clock();
-    T = stop - start;//number of clock ticks the algorithm took
-    double measureTime = T/CLOCKS_PER_SEC;//time in seconds
-    return measureTime;
+    result = result && (show.remove(MAXID) == ABSENT);
+    result = result && (show.countDrones(BLUE) == 63);
+    result = result && (checkHeight(show.m_root) == 5);
+    result = result && binarySearchTest(result, show.m_root);
+
+    return result;
 }
 
-//removeTimeMeasurement
-//displays the time complexity of removal
-double Tester::removeTimeMeasurement(Show& show, int numToBeRemoved){
-    double T = 0.0;//stores running times
-    clock_t start, stop;//stores the clock ticks while running the program
+//testPool
+//tests that drones come from the pool, are recycled after removal, and are released all at once by clear
+bool Tester::testPool(Show& show){
+    bool result = true;
 
-    start = clock();
-    // the algorithm to be measured
-    //removes the drones from the show
-    for (int i = 0; i < numToBeRemoved; i++){
-       show.remove(i + MINID);
+    //checks to ensure tree is empty and the pool has nothing allocated
+    result = result && (show.m_root == nullptr);
+    result = result && (show.m_pool.capacity() == 0);
+
+    //reserve makes room up front, so inserting that many drones does not grow the pool
+    show.reserve(1000);
+    result = result && (show.m_pool.capacity() == 1000);
+    for (int i = 0; i < 1000; i++){
+        show.insert(MINID + i);
+    }
+    result = result && (show.m_pool.capacity() == 1000);
+    result = result && (show.m_pool.inUse() == 1000);
+    result = result && (checkHeight(show.m_root) != 1000);
+    result = result && binarySearchTest(result, show.m_root);
+
+    //removed drones are recycled by later inserts instead of growing the pool
+    for (int i = 0; i < 500; i++){
+        show.remove(MINID + i);
+    }
+    result = result && (show.m_pool.inUse() == 500);
+    for (int i = 0; i < 500; i++){
+        show.insert(MAXID - i);
+    }
+    result = result && (show.m_pool.capacity() == 1000);
+    result = result && (show.m_pool.inUse() == 1000);
+    result = result && show.findDrone(MAXID) && !(show.findDrone(MINID));
+
+    //the pool grows past its reservation when needed
+    show.insert(50000);
+    result = result && (show.m_pool.capacity() > 1000);
+    result = result && (checkHeight(show.m_root) != 1000);
+
+    //removeLightOff releases drones back to the pool as well
+    show.setState(50000, LIGHTOFF);
+    show.removeLightOff();
+    result = result && (show.m_pool.inUse() == 1000);
+
+    //clear releases every slab
+    show.clear();
+    result = result && (show.m_root == nullptr);
+    result = result && (show.m_pool.capacity() == 0);
+    result = result && (show.m_pool.inUse() == 0);
+
+    //the show is still usable after clear
+    result = result && (show.insert(MINID) == INSERTED);
+    result = result && show.findDrone(MINID);
+
+    return result;
+}
+
+//testBulkLoad
+//tests that bulkLoad drops invalid drones and duplicates, and builds a balanced tree on one or more threads
+bool Tester::testBulkLoad(Show& show){
+    bool result = true;
+
+    //checks to ensure tree is empty
+    result = result && (show.m_root == nullptr);
+
+    //roster built in reverse with duplicates and invalid drones mixed in
+    vector<Drone> roster;
+    for (int i = 126; i >= 0; i--){
+        roster.push_back(Drone(MINID + i, BLUE));
+    }
+    roster.push_back(Drone(MINID, RED)); //duplicate, the first BLUE one wins
+    roster.push_back(Drone(MINID - 1));
+    roster.push_back(Drone(MAXID + 1));
+    roster.push_back(Drone(50000, static_cast<LIGHTCOLOR>(3)));
+
+    result = result && (show.bulkLoad(roster.begin(), roster.end()) == 127);
+    result = result && (checkHeight(show.m_root) == 6);
+    result = result && binarySearchTest(result, show.m_root);
+    result = result && (show.countDrones(BLUE) == 127);
+    result = result && !(show.findDrone(50000));
+
+    //merging into a non-empty tree keeps the drones already there
+    Drone extra[] = {Drone(MINID, GREEN), Drone(MINID + 200, GREEN), Drone(MINID + 127, GREEN)};
+    result = result && (show.bulkLoad(extra, extra + 3) == 2);
+    result = result && (show.countDrones(GREEN) == 2);
+    result = result && (show.countDrones(BLUE) == 127);
+    result = result && (checkHeight(show.m_root) == 7);
+    result = result && binarySearchTest(result, show.m_root);
+
+    //the tree is still usable with insert and remove afterwards
+    result = result && (show.insert(MINID + 300) == INSERTED);
+    result = result && (show.remove(MINID + 200) == REMOVED);
+    result = result && (checkHeight(show.m_root) != 1000);
+    result = result && binarySearchTest(result, show.m_root);
+
+    //the largest possible roster, built on four threads, must have the minimum height
+    show.clear();
+    roster.clear();
+    for (int i = MAXID; i >= MINID; i--){
+        roster.push_back(Drone(i, static_cast<LIGHTCOLOR>(i % 3)));
+    }
+    result = result && (show.bulkLoad(roster.begin(), roster.end(), 4) == MAX_SIZE);
+    result = result && (checkHeight(show.m_root) == 16);
+    result = result && binarySearchTest(result, show.m_root);
+    result = result && (show.countDrones(RED) == MAX_SIZE / 3);
+    result = result && show.findDrone(MINID) && show.findDrone(MAXID);
+
+    return result;
+}
+
+//testRemoveIf
+//tests that removeIf removes exactly the drones the predicate holds for and leaves a balanced tree
+bool Tester::testRemoveIf(Show& show){
+    bool result = true;
+
+    //checks to ensure tree is empty, and that removing from an empty tree does nothing
+    result = result && (show.m_root == nullptr);
+    result = result && (show.removeIf([](const Drone&){return true;}) == 0);
+
+    //127 drones, every third one is GREEN
+    for (int i = 0; i < 127; i++){
+        show.insert(MINID + i, ((i % 3 == 0) ? GREEN : RED));
+    }
+    result = result && (show.removeIf([](const Drone& aDrone){return aDrone.getType() == GREEN;}) == 43);
+    result = result && (show.countDrones(GREEN) == 0);
+    result = result && (show.countDrones(RED) == 84);
+    result = result && (checkHeight(show.m_root) == 6);
+    result = result && binarySearchTest(result, show.m_root);
+    result = result && show.findDrone(MINID + 1) && !(show.findDrone(MINID + 3));
+
+    //removed drones were released back to the pool
+    result = result && (show.m_pool.inUse() == 84);
+
+    //a predicate which holds for nothing leaves the tree alone
+    Drone* oldRoot = show.m_root;
+    result = result && (show.removeIf([](const Drone&){return false;}) == 0);
+    result = result && (show.m_root == oldRoot);
+
+    //parallel mode on a full fleet, removing every even ID
+    show.clear();
+    for (int i = MINID; i <= MAXID; i++){
+        show.insert(i, RED, ((i % 2 == 0) ? LIGHTOFF : LIGHTON));
+    }
+    result = result && (show.removeIf([](const Drone& aDrone){return aDrone.getID() % 2 == 0;}, 4) == MAX_SIZE / 2);
+    result = result && (checkHeight(show.m_root) == 15);
+    result = result && binarySearchTest(result, show.m_root);
+    result = result && removeLightHelper(result, show.m_root);
+    result = result && (show.m_pool.inUse() == MAX_SIZE / 2);
+
+    //removing everything leaves an empty tree
+    result = result && (show.removeIf([](const Drone&){return true;}, 4) == MAX_SIZE / 2);
+    result = result && (show.m_root == nullptr);
+
+    return result;
+}
+
+//testSubtreeCounts
+//tests that the subtree counters stay correct through every kind of change, and that range counts match a brute force count
+bool Tester::testSubtreeCounts(Show& show){
+    bool result = true;
+    Random idGen(MINID, MINID + 2000);
+    Random typeGen(0, 2);
+    Random stateGen(0, 1);
+
+    //checks to ensure tree is empty and every count is zero
+    result = result && (show.m_root == nullptr);
+    result = result && (show.countDrones(LIGHTOFF) == 0);
+    result = result && (show.countDrones(RED, LIGHTON, MINID, MAXID) == 0);
+
+    //the ID, color, and state of every drone is mirrored in an array for brute force counting
+    const int SPAN = 2001;
+    int colors[SPAN];
+    int states[SPAN];
+    for (int i = 0; i < SPAN; i++){
+        colors[i] = -1;
+        states[i] = -1;
+    }
+
+    //random inserts, removes, and state changes are mixed together
+    for (int i = 0; i < 6000; i++){
+        int id = idGen.getRandNum();
+        int choice = i % 3;
+        if (choice == 0){
+            LIGHTCOLOR color = static_cast<LIGHTCOLOR>(typeGen.getRandNum());
+            STATE state = static_cast<STATE>(stateGen.getRandNum());
+            if (show.insert(id, color, state) == INSERTED){
+                colors[id - MINID] = color;
+                states[id - MINID] = state;
+            }
+        }
+        else if (choice == 1){
+            if (show.remove(id) == REMOVED){
+                colors[id - MINID] = -1;
+            }
+        }
+        else{
+            STATE state = static_cast<STATE>(stateGen.getRandNum());
+            if (show.setState(id, state)){
+                states[id - MINID] = state;
+            }
+        }
+    }
+    result = result && countHelper(show.m_root);
+
+    //fleet wide counts and ranged counts are compared with the mirror
+    int offCount = 0;
+    for (int i = 0; i < SPAN; i++){
+        offCount += (((colors[i] != -1) && (states[i] == LIGHTOFF)) ? 1 : 0);
+    }
+    result = result && (show.countDrones(LIGHTOFF) == offCount);
+    for (int i = 0; i < 50; i++){
+        int lo = idGen.getRandNum();
+        int hi = lo + (i * 37) % 800;
+        LIGHTCOLOR color = static_cast<LIGHTCOLOR>(i % 3);
+        STATE state = static_cast<STATE>(i % 2);
+        int expected = 0;
+        for (int id = lo; (id <= hi) && (id - MINID < SPAN); id++){
+            expected += (((colors[id - MINID] == color) && (states[id - MINID] == state)) ? 1 : 0);
+        }
+        result = result && (show.countDrones(color, state, lo, hi) == expected);
+    }
+
+    //bounds outside of the valid IDs are handled, and an empty range counts nothing
+    result = result && (show.countDrones(RED, LIGHTON, 0, MAXID + 50) == show.countDrones(RED, LIGHTON, MINID, MAXID));
+    result = result && (show.countDrones(RED, LIGHTON, MAXID, MINID) == 0);
+
+    //counters survive removeLightOff, bulkLoad, and assignment
+    show.removeLightOff();
+    result = result && countHelper(show.m_root) && (show.countDrones(LIGHTOFF) == 0);
+    Drone roster[] = {Drone(50000, BLUE, LIGHTOFF), Drone(50001, GREEN)};
+    show.bulkLoad(roster, roster + 2);
+    result = result && countHelper(show.m_root) && (show.countDrones(LIGHTOFF) == 1);
+    Show copy;
+    copy = show;
+    result = result && countHelper(copy.m_root) && (copy.countDrones(BLUE) == show.countDrones(BLUE));
+
+    return result;
+}
+
+//testOrderStatistics
+//tests rank, select, paging, and sampling
+bool Tester::testOrderStatistics(Show& show){
+    bool result = true;
+
+    //checks to ensure tree is empty and every query handles it
+    result = result && (show.m_root == nullptr);
+    result = result && (show.rank(MINID) == 0);
+    result = result && (show.select(0) == nullptr);
+    mt19937 generator(10);
+    result = result && (show.sampleDrone(generator) == nullptr);
+
+    //every even ID from 10000 to 10998 is inserted, so position i holds ID 10000 + 2i
+    for (int i = 0; i < 500; i++){
+        show.insert(MINID + 2 * i, static_cast<LIGHTCOLOR>(i % 3));
+    }
+    result = result && (show.countDrones() == 500);
+    result = result && countHelper(show.m_root);
+
+    //rank and select are inverses of each other, and rank counts smaller IDs for absent drones too
+    for (int i = 0; i < 500; i++){
+        result = result && (show.rank(MINID + 2 * i) == i);
+        result = result && (show.rank(MINID + 2 * i + 1) == i + 1);
+        result = result && (show.select(i) != nullptr) && (show.select(i)->getID() == MINID + 2 * i);
+    }
+    result = result && (show.select(-1) == nullptr) && (show.select(500) == nullptr);
+    result = result && (show.rank(MAXID) == 500);
+
+    //a page in the middle, a page cut short at the end, and a page past the end
+    Drone page[20];
+    result = result && (show.listDrones(100, 20, page) == 20);
+    for (int i = 0; i < 20; i++){
+        result = result && (page[i].getID() == MINID + 2 * (100 + i));
+        result = result && (page[i].getType() == static_cast<LIGHTCOLOR>((100 + i) % 3));
+    }
+    result = result && (show.listDrones(490, 20, page) == 10);
+    result = result && (page[9].getID() == MINID + 998);
+    result = result && (show.listDrones(500, 20, page) == 0);
+    result = result && (show.listDrones(-1, 20, page) == 0);
+
+    //paging through the whole fleet visits every drone exactly once
+    int numPaged = 0;
+    for (int offset = 0; offset < 500; offset += 20){
+        int numListed = show.listDrones(offset, 20, page);
+        for (int i = 0; i < numListed; i++){
+            result = result && (page[i].getID() == MINID + 2 * (offset + i));
+        }
+        numPaged += numListed;
+    }
+    result = result && (numPaged == 500);
+
+    //sampling only returns drones in the tree, and reaches both halves
+    int lowHalf = 0;
+    for (int i = 0; i < 1000; i++){
+        const Drone* sample = show.sampleDrone(generator);
+        result = result && (sample != nullptr) && show.findDrone(sample->getID());
+        lowHalf += ((sample != nullptr) && (sample->getID() < MINID + 500) ? 1 : 0);
+    }
+    result = result && (lowHalf > 400) && (lowHalf < 600);
+
+    //sizes stay correct after removals
+    for (int i = 0; i < 500; i += 2){
+        show.remove(MINID + 2 * i);
+    }
+    result = result && countHelper(show.m_root);
+    result = result && (show.countDrones() == 250);
+    result = result && (show.select(0)->getID() == MINID + 2);
+
+    return result;
+}
+
+//testOrderedNavigation
+//tests floor, ceiling, successor, predecessor, forEachInRange, and removeRange
+bool Tester::testOrderedNavigation(Show& show){
+    bool result = true;
+
+    //checks to ensure tree is empty and every query handles it
+    result = result && (show.m_root == nullptr);
+    result = result && (show.floor(MAXID) == nullptr) && (show.ceiling(MINID) == nullptr);
+    result = result && (show.removeRange(MINID, MAXID) == 0);
+
+    //every tenth ID from 10000 to 19990 is inserted
+    for (int i = MINID; i < 20000; i += 10){
+        show.insert(i, static_cast<LIGHTCOLOR>((i / 10) % 3));
+    }
+
+    //navigation around present and absent IDs, and past both ends
+    result = result && (show.floor(10055)->getID() == 10050) && (show.floor(10050)->getID() == 10050);
+    result = result && (show.ceiling(10055)->getID() == 10060) && (show.ceiling(10050)->getID() == 10050);
+    result = result && (show.successor(10050)->getID() == 10060) && (show.predecessor(10050)->getID() == 10040);
+    result = result && (show.floor(MINID - 1) == nullptr) && (show.ceiling(19991) == nullptr);
+    result = result && (show.successor(19990) == nullptr) && (show.predecessor(MINID) == nullptr);
+    result = result && (show.successor(MAXID) == nullptr) && (show.ceiling(0)->getID() == MINID);
+
+    //forEachInRange visits exactly the drones in range, in order
+    int visited = 0;
+    int lastID = 0;
+    bool ordered = true;
+    show.forEachInRange(10095, 10505, [&](const Drone& aDrone){
+        ordered = ordered && (aDrone.getID() > lastID) && (aDrone.getID() >= 10095) && (aDrone.getID() <= 10505);
+        lastID = aDrone.getID();
+        visited++;
+    });
+    result = result && ordered && (visited == 41);
+    visited = 0;
+    show.forEachInRange(20000, MAXID, [&](const Drone&){visited++;});
+    result = result && (visited == 0);
+
+    //a block in the middle is removed, and everything else is kept balanced with correct counters
+    int redBefore = show.countDrones(RED);
+    int redInRange = show.countDrones(RED, LIGHTON, 12000, 12999);
+    result = result && (show.removeRange(12000, 12999) == 100);
+    result = result && (show.countDrones() == 900);
+    result = result && !(show.findDrone(12000)) && !(show.findDrone(12990));
+    result = result && show.findDrone(11990) && show.findDrone(13000);
+    result = result && (show.countDrones(RED) == redBefore - redInRange);
+    result = result && (checkHeight(show.m_root) != 1000) && balanceHelper(show.m_root);
+    result = result && binarySearchTest(result, show.m_root) && countHelper(show.m_root);
+    result = result && (show.m_pool.inUse() == 900);
+
+    //blocks at each end, an empty block, and a block past the valid IDs
+    result = result && (show.removeRange(0, 10495) == 50);
+    result = result && (show.removeRange(19000, MAXID + 100) == 100);
+    result = result && (show.removeRange(12000, 12999) == 0);
+    result = result && (show.removeRange(15000, 14000) == 0);
+    result = result && (show.countDrones() == 750);
+    result = result && (show.select(0)->getID() == 10500);
+    result = result && balanceHelper(show.m_root) && countHelper(show.m_root);
+    result = result && binarySearchTest(result, show.m_root);
+
+    //the tree still works normally after the joins
+    result = result && (show.insert(12345) == INSERTED) && (show.remove(13000) == REMOVED);
+    result = result && balanceHelper(show.m_root) && countHelper(show.m_root);
+
+    //removing every block leaves an empty tree
+    result = result && (show.removeRange(MINID, MAXID) == 750);
+    result = result && (show.m_root == nullptr);
+
+    //random inserts and removes are checked to stay balanced, which needs single rotations when children tie
+    Random idGen(MINID, MINID + 3000);
+    for (int i = 0; i < 20000; i++){
+        int id = idGen.getRandNum();
+        if (i % 2 == 0){
+            show.insert(id);
+        }
+        else{
+            show.remove(id);
+        }
+    }
+    result = result && balanceHelper(show.m_root) && (checkHeight(show.m_root) != 1000);
+
+    return result;
+}
+
+//testIterators
+//tests begin, end, lower_bound, and upper_bound, forwards, backwards, and with <algorithm>
+bool Tester::testIterators(Show& show){
+    bool result = true;
+
+    //checks to ensure tree is empty, where begin is end
+    result = result && (show.m_root == nullptr);
+    result = result && (show.begin() == show.end());
+
+    //every third ID from 10000 to 12997 is inserted
+    for (int i = 0; i < 1000; i++){
+        show.insert(MINID + 3 * i, static_cast<LIGHTCOLOR>(i % 3), ((i % 4 == 0) ? LIGHTOFF : LIGHTON));
+    }
+
+    //range for visits every drone in order
+    int position = 0;
+    for (const Drone& aDrone : show){
+        result = result && (aDrone.getID() == MINID + 3 * position);
+        position++;
+    }
+    result = result && (position == 1000);
+
+    //walking backwards from end visits every drone in reverse order
+    position = 1000;
+    Show::const_iterator curr = show.end();
+    while (curr != show.begin()){
+        --curr;
+        position--;
+        result = result && (curr->getID() == MINID + 3 * position);
+    }
+    result = result && (position == 0);
+
+    //the algorithms in <algorithm> and <iterator> work with them
+    result = result && (distance(show.begin(), show.end()) == 1000);
+    result = result && (count_if(show.begin(), show.end(), [](const Drone& aDrone){return aDrone.getState() == LIGHTOFF;}) == 250);
+    Show::const_iterator found = find_if(show.begin(), show.end(), [](const Drone& aDrone){return aDrone.getID() > 11000;});
+    result = result && (found != show.end()) && (found->getID() == 11002);
+    result = result && (prev(show.end())->getID() == 12997);
+
+    //lower_bound and upper_bound on present, absent, and out of range IDs
+    result = result && (show.lower_bound(11002)->getID() == 11002);
+    result = result && (show.lower_bound(11003)->getID() == 11005);
+    result = result && (show.upper_bound(11002)->getID() == 11005);
+    result = result && (show.lower_bound(0) == show.begin());
+    result = result && (show.lower_bound(12998) == show.end());
+    result = result && (show.upper_bound(MAXID) == show.end());
+
+    //a range between two bounds can be walked and counted, and post increment returns the old position
+    result = result && (distance(show.lower_bound(11000), show.upper_bound(11999)) == 333);
+    Show::const_iterator bound = show.lower_bound(11002);
+    result = result && ((bound++)->getID() == 11002) && (bound->getID() == 11005);
+    result = result && ((bound--)->getID() == 11005) && (bound->getID() == 11002);
+
+    //a single drone tree can be walked both ways
+    show.clear();
+    show.insert(50000);
+    result = result && (show.begin()->getID() == 50000) && (++show.begin() == show.end());
+    result = result && (prev(show.end()) == show.begin());
+
+    return result;
+}
+
+//testCompactDrone
+//tests that the compact drone layout is 12 bytes and stores every field without loss
+bool Tester::testCompactDrone(Show& show){
+    bool result = true;
+
+    //checks to ensure tree is empty
+    result = result && (show.m_root == nullptr);
+
+    //a drone is one packed word and two 32-bit links, its counters live apart from it
+    result = result && (sizeof(Drone) <= 12) && (sizeof(DroneLink) == 4);
+
+    //every field reads back what was written, and fields do not overwrite each other
+    Drone aDrone(MAXID, BLUE, LIGHTOFF);
+    aDrone.setHeight(17);
+    result = result && (aDrone.getID() == MAXID) && (aDrone.getType() == BLUE);
+    result = result && (aDrone.getState() == LIGHTOFF) && (aDrone.getHeight() == 17);
+    aDrone.setID(MINID);
+    aDrone.setType(GREEN);
+    result = result && (aDrone.getID() == MINID) && (aDrone.getType() == GREEN);
+    result = result && (aDrone.getState() == LIGHTOFF) && (aDrone.getHeight() == 17);
+    //a drone outside a show has no counters, so it counts as a leaf
+    result = result && (aDrone.getSize() == 1) && (aDrone.getCount(GREEN, LIGHTOFF) == 1);
+
+    //IDs that cannot be stored read back as DEFAULT_ID, and invalid colors and states still read back as invalid
+    aDrone.setID(-30000);
+    result = result && (aDrone.getID() == DEFAULT_ID) && (aDrone.getHeight() == 17);
+    Drone badID(MAXID + 1, RED);
+    Drone badType(50000, static_cast<LIGHTCOLOR>(7));
+    Drone badState(50000, RED, static_cast<STATE>(100));
+    result = result && (badType.getTypeStr() == "UNKNOWN") && (badState.getStateStr() == "UNKNOWN");
+    result = result && (show.insert(badID) == INVALID);
+    result = result && (show.insert(badType) == INVALID) && (show.insert(badState) == INVALID);
+
+    //every counter can hold the largest possible fleet without spilling into its neighbor
+    for (int i = MINID; i <= MAXID; i++){
+        show.insert(i, GREEN, LIGHTOFF);
+    }
+    result = result && (show.countDrones() == MAX_SIZE);
+    result = result && (show.countDrones(GREEN) == MAX_SIZE);
+    result = result && (show.countDrones(BLUE) == 0) && (show.countDrones(RED) == 0);
+    result = result && (show.countDrones(LIGHTON) == 0) && (show.countDrones(LIGHTOFF) == MAX_SIZE);
+    result = result && countHelper(show.m_root) && balanceHelper(show.m_root);
+
+    //moving counts between states on the way down keeps every field intact
+    for (int i = MINID; i <= MAXID; i += 2){
+        show.setState(i, LIGHTON);
+    }
+    result = result && (show.countDrones(LIGHTON) == MAX_SIZE / 2) && (show.countDrones(GREEN) == MAX_SIZE);
+    result = result && countHelper(show.m_root);
+
+    //links are arena indices, so a copy in another show resolves to its own drones
+    Show copy;
+    copy = show;
+    show.clear();
+    result = result && (copy.countDrones() == MAX_SIZE) && (copy.countDrones(LIGHTON) == MAX_SIZE / 2);
+    result = result && countHelper(copy.m_root) && balanceHelper(copy.m_root);
+
+    //blocks handed back by clear are reused, and the drones built in them are fresh
+    for (int i = MINID; i < MINID + 1000; i++){
+        show.insert(i, RED, LIGHTON);
+    }
+    result = result && (show.countDrones() == 1000) && (show.countDrones(RED) == 1000);
+    result = result && countHelper(show.m_root) && balanceHelper(show.m_root);
+
+    return result;
+}
+
+//testFreeze
+//tests that a frozen snapshot answers single and batched lookups exactly like the tree
+bool Tester::testFreeze(Show& show){
+    bool result = true;
+
+    //checks to ensure tree is empty, and that an empty snapshot holds nothing
+    result = result && (show.m_root == nullptr);
+    FrozenShow empty = show.freeze();
+    result = result && (empty.size() == 0) && !(empty.contains(MINID)) && !(empty.contains(MAXID + 1));
+
+    //a fleet whose size is not one less than a power of two, so the snapshot needs padding
+    Random idGen(MINID, MAXID);
+    for (int i = 0; i < 3000; i++){
+        show.insert(idGen.getRandNum());
+    }
+    FrozenShow frozen = show.freeze();
+    result = result && (frozen.size() == show.countDrones());
+
+    //every valid ID, and a few invalid ones, is answered the same as findDrone
+    for (int id = MINID - 5; id <= MAXID + 5; id++){
+        result = result && (frozen.contains(id) == show.findDrone(id));
+    }
+    result = result && !(frozen.contains(-1)) && !(frozen.contains(MAXID + 1));
+
+    //batched lookups of an odd length match single lookups bit for bit
+    const int BATCH = 1000;
+    int ids[BATCH];
+    uint64_t found[(BATCH + 63) / 64];
+    for (int i = 0; i < BATCH; i++){
+        ids[i] = ((i % 7 == 0) ? MAXID + 1 : idGen.getRandNum());
+    }
+    frozen.contains(ids, BATCH - 3, found);
+    for (int i = 0; i < BATCH - 3; i++){
+        bool bit = (found[i / 64] >> (i % 64)) & 1;
+        result = result && (bit == show.findDrone(ids[i]));
+    }
+
+    //the snapshot does not change with the tree, and copies are independent
+    int firstID = show.begin()->getID();
+    show.remove(firstID);
+    result = result && frozen.contains(firstID);
+    FrozenShow copy(frozen);
+    frozen = show.freeze();
+    result = result && !(frozen.contains(firstID)) && copy.contains(firstID);
+
+    //a snapshot of a full fleet holds every ID
+    show.clear();
+    for (int i = MINID; i <= MAXID; i++){
+        show.insert(i);
+    }
+    frozen = show.freeze();
+    result = result && frozen.contains(MINID) && frozen.contains(MAXID) && frozen.contains(54321);
+    result = result && !(frozen.contains(MINID - 1));
+
+    return result;
+}
+
+//testBatchedLookups
+//tests that findDrones and setStates give the same answers as findDrone and setState one at a time
+bool Tester::testBatchedLookups(Show& show){
+    bool result = true;
+    Random idGen(MINID, MINID + 5000);
+
+    //checks to ensure tree is empty, where nothing is found and nothing changes
+    result = result && (show.m_root == nullptr);
+    int oneID[] = {MINID};
+    bool oneFound[] = {true};
+    show.findDrones(oneID, 1, oneFound);
+    result = result && !(oneFound[0]);
+
+    //a mirror show gets the same drones, and is only ever changed one call at a time
+    Show mirror;
+    for (int i = 0; i < 2500; i++){
+        int id = idGen.getRandNum();
+        show.insert(id, static_cast<LIGHTCOLOR>(i % 3));
+        mirror.insert(id, static_cast<LIGHTCOLOR>(i % 3));
+    }
+
+    //a batch whose length is not a multiple of the lanes, including invalid IDs
+    const int BATCH = 301;
+    int ids[BATCH];
+    bool found[BATCH];
+    for (int i = 0; i < BATCH; i++){
+        ids[i] = ((i % 50 == 0) ? MAXID + 1 : idGen.getRandNum());
+    }
+    show.findDrones(ids, BATCH, found);
+    for (int i = 0; i < BATCH; i++){
+        result = result && (found[i] == show.findDrone(ids[i]));
+    }
+
+    //state updates with repeated IDs and an invalid state, applied in order
+    pair<int, STATE> updates[BATCH];
+    bool changed[BATCH];
+    for (int i = 0; i < BATCH; i++){
+        updates[i] = make_pair(ids[i / 2], ((i % 3 == 0) ? LIGHTOFF : LIGHTON));
+    }
+    updates[7].second = static_cast<STATE>(2);
+    show.setStates(updates, BATCH, changed);
+    for (int i = 0; i < BATCH; i++){
+        result = result && (changed[i] == mirror.setState(updates[i].first, updates[i].second));
+    }
+
+    //the counters and states of both shows agree afterwards
+    result = result && countHelper(show.m_root);
+    result = result && (show.countDrones(LIGHTOFF) == mirror.countDrones(LIGHTOFF));
+    result = result && assignmentHelper(result, show.m_root, mirror.m_root);
+
+    return result;
+}
+
+//testBucketShow
+//runs the same random inserts, removes, and state changes on a BucketShow and a Show, then compares them
+bool Tester::testBucketShow(Show& show){
+    bool result = true;
+    BucketShow buckets;
+    Random idGen(MINID, MINID + 4000);
+    Random opGen(0, 9);
+    opGen.setSeed(20); //a different seed keeps the operation independent of the ID
+
+    //checks to ensure tree is empty, where nothing is found or removed
+    result = result && (buckets.m_root == nullptr) && !(buckets.findDrone(MINID));
+    result = result && (buckets.remove(MINID) == ABSENT);
+    result = result && (buckets.insert(MAXID + 1, RED) == INVALID);
+
+    //for loop mixes the operations so buckets split, empty, and merge many times
+    for (int i = 0; i < 30000; i++){
+        int id = idGen.getRandNum();
+        int op = opGen.getRandNum();
+        if (op < 5){
+            LIGHTCOLOR type = static_cast<LIGHTCOLOR>(i % 3);
+            result = result && (buckets.insert(id, type) == show.insert(id, type));
+        }
+        else if (op < 9){
+            result = result && (buckets.remove(id) == show.remove(id));
+        }
+        else{
+            result = result && (buckets.setState(id, LIGHTOFF) == show.setState(id, LIGHTOFF));
+        }
+    }
+    int prevID = MINID - 1;
+    result = result && bucketHelper(buckets.m_root, prevID);
+
+    //every ID in the range is found by both or by neither, and the counts agree
+    for (int id = MINID; id <= MINID + 4000; id++){
+        result = result && (buckets.findDrone(id) == show.findDrone(id));
+    }
+    result = result && (buckets.countDrones() == show.countDrones());
+    result = result && (buckets.countDrones(GREEN) == show.countDrones(GREEN));
+    result = result && (buckets.countDrones(LIGHTOFF) == show.countDrones(LIGHTOFF));
+
+    //every ID agrees on rank and its neighbors, including IDs outside the range in use
+    for (int id = MINID - 1; id <= MINID + 4001; id++){
+        const Drone* floorDrone = show.floor(id);
+        const Drone* ceilingDrone = show.ceiling(id);
+        const Drone* nextDrone = show.successor(id);
+        const Drone* prevDrone = show.predecessor(id);
+        result = result && (buckets.rank(id) == show.rank(id));
+        result = result && (buckets.floor(id) == ((floorDrone == nullptr) ? NO_DRONE : floorDrone->getID()));
+        result = result && (buckets.ceiling(id) == ((ceilingDrone == nullptr) ? NO_DRONE : ceilingDrone->getID()));
+        result = result && (buckets.successor(id) == ((nextDrone == nullptr) ? NO_DRONE : nextDrone->getID()));
+        result = result && (buckets.predecessor(id) == ((prevDrone == nullptr) ? NO_DRONE : prevDrone->getID()));
+    }
+
+    //positions, pages, range counts, and batches agree
+    int numDrones = show.countDrones();
+    result = result && (buckets.select(numDrones) == NO_DRONE) && (buckets.select(-1) == NO_DRONE);
+    for (int k = 0; k < numDrones; k += 7){
+        result = result && (buckets.select(k) == show.select(k)->getID());
+    }
+    Drone bucketBuffer[50];
+    Drone showBuffer[50];
+    int numCopied = buckets.listDrones(numDrones - 20, 50, bucketBuffer);
+    result = result && (numCopied == 20) && (numCopied == show.listDrones(numDrones - 20, 50, showBuffer));
+    for (int i = 0; i < numCopied; i++){
+        result = result && (bucketBuffer[i].getID() == showBuffer[i].getID()) && (bucketBuffer[i].getType() == showBuffer[i].getType());
+    }
+    for (int color = RED; color <= BLUE; color++){
+        for (int lo = MINID - 5; lo < MINID + 4000; lo += 397){
+            result = result && (buckets.countDrones(static_cast<LIGHTCOLOR>(color), LIGHTOFF, lo, lo + 613)
+                                == show.countDrones(static_cast<LIGHTCOLOR>(color), LIGHTOFF, lo, lo + 613));
+        }
+    }
+    int ids[3] = {show.select(0)->getID(), MINID + 4001, show.select(numDrones - 1)->getID()};
+    bool found[3];
+    buckets.findDrones(ids, 3, found);
+    result = result && found[0] && !(found[1]) && found[2];
+    pair<int, STATE> updates[3] = {{ids[0], LIGHTOFF}, {ids[1], LIGHTOFF}, {ids[0], LIGHTON}};
+    bool changed[3];
+    buckets.setStates(updates, 3, changed);
+    bool wasOn = show.setState(ids[0], LIGHTOFF);
+    show.setState(ids[0], LIGHTON);
+    result = result && (changed[0] == wasOn) && !(changed[1]) && changed[2];
+    int visited = 0;
+    int prevVisited = MINID - 1;
+    buckets.forEachInRange(MINID + 1000, MINID + 1999, [&](const Drone& aDrone){
+        result = result && (aDrone.getID() > prevVisited) && (aDrone.getID() >= MINID + 1000) && (aDrone.getID() <= MINID + 1999);
+        prevVisited = aDrone.getID();
+        visited++;
+    });
+    result = result && (visited == show.rank(MINID + 2000) - show.rank(MINID + 1000));
+
+    //ranges cutting through buckets at both ends, and a range inside one bucket, are removed from both
+    result = result && (buckets.removeRange(MINID + 1003, MINID + 2011) == show.removeRange(MINID + 1003, MINID + 2011));
+    result = result && (buckets.removeRange(MINID + 3001, MINID + 3004) == show.removeRange(MINID + 3001, MINID + 3004));
+    result = result && (buckets.removeRange(MINID + 10, MINID + 5) == 0);
+    prevID = MINID - 1;
+    result = result && bucketHelper(buckets.m_root, prevID) && (buckets.countDrones() == show.countDrones());
+
+    //a roster loaded into both adds the same drones, with the ones already in the tree kept
+    vector<Drone> roster;
+    for (int id = MINID + 3500; id <= MINID + 6000; id += 3){
+        roster.push_back(Drone(id, BLUE, LIGHTOFF));
+    }
+    roster.push_back(Drone(MAXID + 1, RED, LIGHTON));
+    result = result && (buckets.bulkLoad(roster.begin(), roster.end()) == show.bulkLoad(roster.begin(), roster.end()));
+    prevID = MINID - 1;
+    result = result && bucketHelper(buckets.m_root, prevID) && (buckets.countDrones() == show.countDrones());
+    result = result && (buckets.countDrones(BLUE) == show.countDrones(BLUE)) && (buckets.countDrones(LIGHTOFF) == show.countDrones(LIGHTOFF));
+    FrozenShow frozen = buckets.freeze();
+    result = result && (frozen.size() == show.countDrones());
+    for (int id = MINID; id <= MINID + 6001; id++){
+        result = result && (buckets.findDrone(id) == show.findDrone(id)) && (frozen.contains(id) == show.findDrone(id));
+    }
+    mt19937 generator(7);
+    result = result && buckets.findDrone(buckets.sampleDrone(generator));
+
+    //a copy matches, and keeps matching once the lights off are removed from both
+    BucketShow copy;
+    copy = buckets;
+    buckets.removeLightOff();
+    show.removeLightOff();
+    prevID = MINID - 1;
+    result = result && bucketHelper(buckets.m_root, prevID);
+    result = result && (buckets.countDrones() == show.countDrones());
+    result = result && (buckets.countDrones(LIGHTOFF) == 0);
+    result = result && (copy.countDrones(LIGHTOFF) != 0);
+    for (int id = MINID; id <= MINID + 6001; id++){
+        result = result && (buckets.findDrone(id) == show.findDrone(id));
+    }
+    result = result && (buckets.removeIf([](const Drone& aDrone){return aDrone.getType() == RED;}) == show.removeIf([](const Drone& aDrone){return aDrone.getType() == RED;}));
+    prevID = MINID - 1;
+    result = result && bucketHelper(buckets.m_root, prevID) && (buckets.countDrones() == show.countDrones()) && (buckets.countDrones(RED) == 0);
+
+    buckets.clear();
+    result = result && (buckets.m_root == nullptr) && (buckets.countDrones() == 0);
+    return result;
+}
+
+//testDenseShow
+//runs the same changes on a DenseShow and a Show, then compares every lookup, navigation, and count
+bool Tester::testDenseShow(Show& show){
+    bool result = true;
+    DenseShow dense;
+    Random idGen(MINID, MAXID);
+    Random opGen(0, 9);
+    opGen.setSeed(20); //a different seed keeps the operation independent of the ID
+
+    //checks to ensure the show is empty, where nothing is found and navigation finds nothing
+    result = result && (dense.countDrones() == 0) && !(dense.findDrone(MINID));
+    result = result && (dense.ceiling(MINID) == NO_DRONE) && (dense.floor(MAXID) == NO_DRONE);
+    result = result && (dense.select(0) == NO_DRONE) && (dense.remove(MINID) == ABSENT);
+    result = result && (dense.insert(MINID - 1, RED) == INVALID) && (dense.insert(MINID, static_cast<LIGHTCOLOR>(5)) == INVALID);
+
+    //the first and last IDs, then a random mix of changes
+    result = result && (dense.insert(MINID, BLUE) == show.insert(MINID, BLUE));
+    result = result && (dense.insert(MAXID, GREEN) == show.insert(MAXID, GREEN));
+    for (int i = 0; i < 40000; i++){
+        int id = idGen.getRandNum();
+        int op = opGen.getRandNum();
+        if (op < 6){
+            LIGHTCOLOR type = static_cast<LIGHTCOLOR>(i % 3);
+            result = result && (dense.insert(id, type) == show.insert(id, type));
+        }
+        else if (op < 8){
+            result = result && (dense.remove(id) == show.remove(id));
+        }
+        else{
+            result = result && (dense.setState(id, LIGHTOFF) == show.setState(id, LIGHTOFF));
+        }
+    }
+
+    //every ID agrees on membership, rank, and its neighbors
+    for (int id = MINID - 1; id <= MAXID + 1; id++){
+        const Drone* floorDrone = show.floor(id);
+        const Drone* ceilingDrone = show.ceiling(id);
+        const Drone* nextDrone = show.successor(id);
+        const Drone* prevDrone = show.predecessor(id);
+        result = result && (dense.findDrone(id) == show.findDrone(id)) && (dense.rank(id) == show.rank(id));
+        result = result && (dense.floor(id) == ((floorDrone == nullptr) ? NO_DRONE : floorDrone->getID()));
+        result = result && (dense.ceiling(id) == ((ceilingDrone == nullptr) ? NO_DRONE : ceilingDrone->getID()));
+        result = result && (dense.successor(id) == ((nextDrone == nullptr) ? NO_DRONE : nextDrone->getID()));
+        result = result && (dense.predecessor(id) == ((prevDrone == nullptr) ? NO_DRONE : prevDrone->getID()));
+    }
+
+    //positions, pages, and counts agree
+    int numDrones = show.countDrones();
+    result = result && (dense.countDrones() == numDrones) && (dense.select(numDrones) == NO_DRONE);
+    for (int k = 0; k < numDrones; k += 97){
+        result = result && (dense.select(k) == show.select(k)->getID());
+    }
+    Drone denseBuffer[50];
+    Drone showBuffer[50];
+    int numCopied = dense.listDrones(numDrones - 20, 50, denseBuffer);
+    result = result && (numCopied == 20) && (numCopied == show.listDrones(numDrones - 20, 50, showBuffer));
+    for (int i = 0; i < numCopied; i++){
+        result = result && (denseBuffer[i].getID() == showBuffer[i].getID()) && (denseBuffer[i].getType() == showBuffer[i].getType());
+    }
+    for (int color = RED; color <= BLUE; color++){
+        result = result && (dense.countDrones(static_cast<LIGHTCOLOR>(color)) == show.countDrones(static_cast<LIGHTCOLOR>(color)));
+        result = result && (dense.countDrones(static_cast<LIGHTCOLOR>(color), LIGHTOFF, 20000, 20500)
+                            == show.countDrones(static_cast<LIGHTCOLOR>(color), LIGHTOFF, 20000, 20500));
+    }
+    result = result && (dense.countDrones(LIGHTOFF) == show.countDrones(LIGHTOFF));
+
+    //a range across many words is removed from both, and a copy and a snapshot still agree
+    result = result && (dense.removeRange(30001, 60123) == show.removeRange(30001, 60123));
+    DenseShow copy;
+    copy = dense;
+    FrozenShow frozen = dense.freeze();
+    result = result && (frozen.size() == show.countDrones());
+    dense.removeLightOff();
+    show.removeLightOff();
+    for (int id = MINID; id <= MAXID; id++){
+        result = result && (dense.findDrone(id) == show.findDrone(id)) && (frozen.contains(id) == copy.findDrone(id));
+    }
+    result = result && (dense.countDrones() == show.countDrones()) && (dense.countDrones(LIGHTOFF) == 0);
+
+    dense.clear();
+    result = result && (dense.countDrones() == 0) && (dense.ceiling(MINID) == NO_DRONE);
+    return result;
+}
+
+//testIndexes
+//checks the bitmaps on their own, then checks that an indexed show answers every filtered walk like an unindexed one
+bool Tester::testIndexes(Show& show){
+    bool result = true;
+
+    //a bitmap switches to a bitmap container past ARRAY_LIMIT and back to an array once it shrinks
+    DroneBitmap evens;
+    DroneBitmap thirds;
+    for (int id = MINID; id <= MAXID; id += 2){
+        evens.add(id);
+    }
+    for (int id = MINID; id <= MAXID; id += 3){
+        thirds.add(id);
+    }
+    result = result && !(evens.add(MINID)) && evens.contains(MINID) && !(evens.contains(MINID + 1));
+    result = result && (evens.cardinality() == (MAXID - MINID) / 2 + 1) && evens.m_containers[0].isBitmap();
+    int numBoth = 0;
+    int prevID = 0;
+    DroneBitmap::forEachIntersection(evens, thirds, [&](int id){
+        result = result && (id > prevID) && ((id - MINID) % 6 == 0);
+        prevID = id;
+        numBoth++;
+    });
+    result = result && (numBoth == (MAXID - MINID) / 6 + 1);
+    for (int id = MINID; id < 62000; id += 2){
+        evens.remove(id);
+    }
+    result = result && !(evens.m_containers[0].isBitmap()) && !(evens.remove(MINID)) && evens.contains(62000);
+
+    //an indexed show and a plain one get the same drones and the same changes
+    Show plain;
+    show.enableIndexes();
+    Random idGen(MINID, MINID + 20000);
+    for (int i = 0; i < 12000; i++){
+        int id = idGen.getRandNum();
+        show.insert(id, static_cast<LIGHTCOLOR>(i % 3));
+        plain.insert(id, static_cast<LIGHTCOLOR>(i % 3));
+    }
+    for (int i = 0; i < 3000; i++){
+        int id = idGen.getRandNum();
+        result = result && (show.setState(id, LIGHTOFF) == plain.setState(id, LIGHTOFF));
+        id = idGen.getRandNum();
+        result = result && (show.remove(id) == plain.remove(id));
+    }
+    pair<int, STATE> updates[100];
+    bool changed[100];
+    for (int i = 0; i < 100; i++){
+        updates[i] = make_pair(idGen.getRandNum(), LIGHTOFF);
+    }
+    show.setStates(updates, 100, changed);
+    plain.setStates(updates, 100, changed);
+    vector<Drone> roster;
+    for (int id = MINID + 20001; id < MINID + 20500; id++){
+        roster.push_back(Drone(id, BLUE, LIGHTOFF));
+    }
+    show.bulkLoad(roster.begin(), roster.end());
+    plain.bulkLoad(roster.begin(), roster.end());
+    result = result && (show.removeRange(15000, 16000) == plain.removeRange(15000, 16000));
+    result = result && (show.removeIf([](const Drone& aDrone){return aDrone.getID() % 7 == 0;})
+                        == plain.removeIf([](const Drone& aDrone){return aDrone.getID() % 7 == 0;}));
+
+    //walks every filtered list of both shows side by side
+    vector<int> indexed;
+    vector<int> scanned;
+    for (int color = RED; color <= BLUE; color++){
+        for (int state = LIGHTON; state <= LIGHTOFF; state++){
+            LIGHTCOLOR aColor = static_cast<LIGHTCOLOR>(color);
+            STATE aState = static_cast<STATE>(state);
+            indexed.clear();
+            scanned.clear();
+            show.forEachMatching(aColor, aState, [&](const Drone& aDrone){
+                result = result && (aDrone.getType() == aColor) && (aDrone.getState() == aState);
+                indexed.push_back(aDrone.getID());
+            });
+            plain.forEachMatching(aColor, aState, [&](const Drone& aDrone){scanned.push_back(aDrone.getID());});
+            result = result && (indexed == scanned) && ((int)indexed.size() == show.countDrones(aColor, aState, MINID, MAXID));
+        }
+        indexed.clear();
+        scanned.clear();
+        show.forEachMatching(static_cast<LIGHTCOLOR>(color), [&](const Drone& aDrone){indexed.push_back(aDrone.getID());});
+        plain.forEachMatching(static_cast<LIGHTCOLOR>(color), [&](const Drone& aDrone){scanned.push_back(aDrone.getID());});
+        result = result && (indexed == scanned);
+    }
+    result = result && (show.m_stateIndex[LIGHTOFF].cardinality() == plain.countDrones(LIGHTOFF));
+
+    //a few drones off are removed one at a time, and the bitmaps follow
+    show.removeLightOff();
+    plain.removeLightOff();
+    show.setState(show.select(0)->getID(), LIGHTOFF);
+    plain.setState(plain.select(0)->getID(), LIGHTOFF);
+    show.removeLightOff();
+    plain.removeLightOff();
+    //the removals reshape the two trees differently, so their drones are compared in order rather than their shapes
+    indexed.clear();
+    scanned.clear();
+    for (const Drone& curr : show){
+        indexed.push_back(curr.getID());
+    }
+    for (const Drone& curr : plain){
+        scanned.push_back(curr.getID());
+    }
+    result = result && (indexed == scanned) && countHelper(show.m_root) && balanceHelper(show.m_root);
+    result = result && (show.m_stateIndex[LIGHTOFF].cardinality() == 0);
+    result = result && (show.m_stateIndex[LIGHTON].cardinality() == show.countDrones());
+
+    //assignment rebuilds the bitmaps for the new drones, and clear empties them
+    Show copy;
+    copy.enableIndexes();
+    copy = show;
+    result = result && (copy.m_colorIndex[GREEN].cardinality() == show.countDrones(GREEN));
+    show.clear();
+    result = result && show.hasIndexes() && (show.m_colorIndex[RED].cardinality() == 0);
+    show.disableIndexes();
+    result = result && !(show.hasIndexes());
+    return result;
+}
+
+//testCompact
+//churns a tree so its drones are scattered, then checks that both layouts and the incremental mode keep every drone and link
+bool Tester::testCompact(Show& show){
+    bool result = true;
+    Random idGen(MINID, MAXID);
+
+    //an empty tree compacts to nothing
+    CompactReport report = show.compact();
+    result = result && (show.m_root == nullptr) && (show.m_pool.capacity() == 0);
+
+    //inserts and removes interleaved so drones are recycled out of order
+    for (int i = 0; i < 20000; i++){
+        show.insert(idGen.getRandNum(), static_cast<LIGHTCOLOR>(i % 3));
+        if (i % 3 == 0){
+            show.remove(show.select(idGen.getRandNum() % show.countDrones())->getID());
+        }
+    }
+    Show mirror;
+    mirror = show;
+
+    //in order layout makes an in order scan sequential, and leaves the shape of the tree alone
+    report = show.compact(INORDER);
+    result = result && (report.scanBefore > 1) && (report.scanAfter == 1) && (show.scanStride() == 1);
+    result = result && assignmentHelper(result, show.m_root, mirror.m_root) && countHelper(show.m_root);
+    result = result && (show.m_pool.capacity() == show.countDrones()) && (show.m_pool.m_slabs.size() == 1);
+
+    //van Emde Boas layout puts the root first, and searches touch fewer pages than with the in order layout
+    report = show.compact(VANEMDEBOAS);
+    result = result && (show.m_root == show.m_pool.m_slabs[0]) && (report.descentAfter < report.descentBefore);
+    result = result && assignmentHelper(result, show.m_root, mirror.m_root) && countHelper(show.m_root);
+
+    //the incremental mode runs while drones are inserted, removed, and changed between steps
+    for (int i = 0; i < 3000; i++){
+        show.remove(show.select(idGen.getRandNum() % show.countDrones())->getID());
+    }
+    int numSteps = 0;
+    bool finished = false;
+    while (!finished){
+        finished = show.compactStep(500);
+        int id = idGen.getRandNum();
+        show.insert(id, BLUE);
+        show.setState(id, LIGHTOFF);
+        show.remove(show.select(idGen.getRandNum() % show.countDrones())->getID());
+        numSteps++;
+    }
+    result = result && (numSteps > 1) && !(show.m_pool.relocating()) && (show.m_compactCursor == NOT_COMPACTING);
+    result = result && (show.m_pool.m_slabs.size() <= 2) && (show.scanStride() < report.scanAfter);
+    result = result && binarySearchTest(result, show.m_root) && countHelper(show.m_root) && balanceHelper(show.m_root);
+
+    //a fresh drone comes from the pool, and clear in the middle of a compaction leaves nothing behind
+    mirror = show;
+    show.compactStep(100);
+    result = result && show.m_pool.relocating() && (show.insert(MINID, RED) == mirror.insert(MINID, RED));
+    show.clear();
+    result = result && !(show.m_pool.relocating()) && (show.m_pool.capacity() == 0) && (show.compactStep(10));
+    return result;
+}
+
+//testInlineMode
+//runs the same changes on an inline show and a plain one, checking that they always answer alike
+//and that the inline show moves to the pool and back as it crosses its limits
+bool Tester::testInlineMode(Show& show){
+    bool result = true;
+    Show plain;
+    Random idGen(MINID, MINID + 200);
+
+    //inline mode is off by default, and an empty show turns inline as soon as it is on
+    result = result && !(show.isInline());
+    show.setInlineLimits(16, 8);
+    show.enableIndexes();
+    result = result && show.isInline() && (show.m_pool.capacity() == 0);
+
+    //up to 16 drones stay inline, in a balanced tree with correct counters and no pool slab
+    for (int i = 0; i < 40; i++){
+        int id = idGen.getRandNum();
+        LIGHTCOLOR type = static_cast<LIGHTCOLOR>(i % 3);
+        result = result && (show.insert(id, type) == plain.insert(id, type));
+        if (plain.countDrones() == 16){
+            break;
+        }
+    }
+    result = result && show.isInline() && (show.m_pool.capacity() == 0) && (show.countDrones() == 16);
+    result = result && (show.m_root >= show.m_inline) && (show.m_root < show.m_inline + INLINE_CAPACITY);
+    result = result && balanceHelper(show.m_root) && countHelper(show.m_root) && binarySearchTest(result, show.m_root);
+    result = result && (show.insert(MAXID + 1, RED) == INVALID) && (show.insert(plain.select(3)->getID(), RED) == DUPLICATE);
+
+    //every query agrees with the plain show
+    for (int id = MINID - 1; id <= MINID + 201; id++){
+        const Drone* inlineFloor = show.floor(id);
+        const Drone* plainFloor = plain.floor(id);
+        result = result && (show.findDrone(id) == plain.findDrone(id)) && (show.rank(id) == plain.rank(id));
+        result = result && ((inlineFloor == nullptr) == (plainFloor == nullptr));
+        result = result && ((inlineFloor == nullptr) || (inlineFloor->getID() == plainFloor->getID()));
+    }
+    result = result && equal(show.begin(), show.end(), plain.begin(),
+                             [](const Drone& lhs, const Drone& rhs){return lhs.getID() == rhs.getID();});
+    int id = show.select(5)->getID();
+    result = result && (show.setState(id, LIGHTOFF) == plain.setState(id, LIGHTOFF));
+    result = result && (show.countDrones(LIGHTOFF) == 1) && (show.m_stateIndex[LIGHTOFF].contains(id));
+    result = result && (show.remove(id) == REMOVED) && (plain.remove(id) == REMOVED) && (show.remove(id) == ABSENT);
+    result = result && show.isInline() && (show.countDrones() == 15);
+
+    //past 16 the drones move to the pool, and below 8 they come back inline and the pool is freed
+    for (int i = 0; show.countDrones() < 20; i++){
+        id = MINID + 300 + i;
+        show.insert(id, BLUE);
+        plain.insert(id, BLUE);
+    }
+    result = result && !(show.isInline()) && (show.m_pool.inUse() == 20) && countHelper(show.m_root);
+    while (show.countDrones() > 7){
+        id = show.select(show.countDrones() / 2)->getID();
+        result = result && (show.remove(id) == plain.remove(id));
+    }
+    result = result && show.isInline() && (show.m_pool.capacity() == 0) && (show.m_numInline == 7);
+    result = result && equal(show.begin(), show.end(), plain.begin(),
+                             [](const Drone& lhs, const Drone& rhs){return lhs.getID() == rhs.getID();});
+
+    //operations on many drones at once move an inline show to the pool and back as needed
+    vector<Drone> roster;
+    for (int i = 0; i < 30; i++){
+        roster.push_back(Drone(MINID + 500 + i, GREEN, LIGHTOFF));
+    }
+    result = result && (show.bulkLoad(roster.begin(), roster.end()) == plain.bulkLoad(roster.begin(), roster.end()));
+    result = result && !(show.isInline()) && (show.countDrones() == plain.countDrones());
+    result = result && (show.removeRange(MINID + 505, MINID + 600) == plain.removeRange(MINID + 505, MINID + 600));
+    result = result && !(show.isInline()) && (show.countDrones() == 12) && (plain.countDrones() == 12);
+    show.removeLightOff();
+    plain.removeLightOff();
+    result = result && show.isInline() && (show.countDrones() == plain.countDrones()) && (show.countDrones(GREEN) == plain.countDrones(GREEN));
+    result = result && (show.m_colorIndex[GREEN].cardinality() == show.countDrones(GREEN)) && (show.m_stateIndex[LIGHTOFF].cardinality() == 0);
+
+    //a small copy goes inline, a show that turns inline mode off moves to the pool
+    Show copy;
+    copy.setInlineLimits(16, 8);
+    copy = plain;
+    result = result && copy.isInline() && equal(copy.begin(), copy.end(), plain.begin(),
+                                                [](const Drone& lhs, const Drone& rhs){return lhs.getID() == rhs.getID();});
+    //a copy too large to go inline is built in the pool, and later inserts and lookups see every copied drone
+    Show small;
+    Show large;
+    for (int i = 0; i < 5; i++){
+        small.insert(MINID + 10 * i);
+    }
+    for (int i = 0; i < 20; i++){
+        large.insert(MINID + 10 * i);
+    }
+    Show limited;
+    limited.setInlineLimits(8, 2);
+    limited = small;
+    result = result && limited.isInline() && (limited.insert(MINID + 1) == INSERTED) && (limited.countDrones() == 6);
+    result = result && limited.findDrone(MINID + 40) && (limited.remove(MINID) == REMOVED);
+    limited = large;
+    result = result && !(limited.isInline()) && (limited.insert(MINID + 1) == INSERTED) && (limited.countDrones() == 21);
+    result = result && limited.findDrone(MINID + 190) && (limited.remove(MINID + 100) == REMOVED) && countHelper(limited.m_root);
+    result = result && (limited.m_pool.inUse() == 20);
+    show.setInlineLimits(0, 0);
+    result = result && !(show.isInline()) && (show.m_pool.inUse() == plain.countDrones()) && countHelper(show.m_root);
+    show.clear();
+    result = result && !(show.isInline()) && (show.m_root == nullptr);
+    return result;
+}
+
+//testTreeCore
+//runs random inserts, removes, and finds on a TreeCore with keys wider than an int against std::map
+//then checks rank, select, and removeRange, and that every node is balanced and sized correctly
+//Show shares the same kernels, so every other test block covers them on Drones
+bool Tester::testTreeCore(Show& show){
+    bool result = true;
+    TreeCore<long long, int> core;
+    map<long long, int> mirror;
+    Random keyGen(0, 5000);
+    Random opGen(0, 2);
+    opGen.setSeed(20);
+    const long long base = 1LL << 40;//every key is past the range of an int
+    for (int i = 0; i < 20000; i++){
+        long long key = base + keyGen.getRandNum();
+        int op = opGen.getRandNum();
+        if (op == 0){
+            result = result && (core.insert(key, i) == mirror.insert(make_pair(key, i)).second);
+        }
+        else if (op == 1){
+            result = result && (core.remove(key) == (mirror.erase(key) == 1));
+        }
+        else{
+            const int* payload = core.find(key);
+            map<long long, int>::iterator found = mirror.find(key);
+            result = result && ((payload == nullptr) == (found == mirror.end()));
+            result = result && ((payload == nullptr) || (*payload == found->second));
+        }
+    }
+    result = result && (core.size() == (int)mirror.size());
+
+    //every node is balanced, and its height and size agree with its children
+    typedef TreeCore<long long, int>::Node CoreNode;
+    core.forEach([&](const CoreNode& node){
+        int leftHeight = ((node.getLeft() == nullptr) ? -1 : node.getLeft()->getHeight());
+        int rightHeight = ((node.getRight() == nullptr) ? -1 : node.getRight()->getHeight());
+        int leftSize = ((node.getLeft() == nullptr) ? 0 : node.getLeft()->getSize());
+        int rightSize = ((node.getRight() == nullptr) ? 0 : node.getRight()->getSize());
+        result = result && (leftHeight - rightHeight >= -1) && (leftHeight - rightHeight <= 1);
+        result = result && (node.getHeight() == 1 + max(leftHeight, rightHeight)) && (node.getSize() == 1 + leftSize + rightSize);
+    });
+
+    //the walk is in key order, and rank and select agree with the position in it
+    int position = 0;
+    map<long long, int>::iterator it = mirror.begin();
+    core.forEach([&](const CoreNode& node){
+        result = result && (node.getKey() == it->first) && (core.rank(node.getKey()) == position);
+        result = result && (core.select(position) == &node);
+        position++;
+        it++;
+    });
+    result = result && (core.select(-1) == nullptr) && (core.select(core.size()) == nullptr);
+
+    //removeRange takes out both ends of the range and leaves a balanced tree
+    long long lo = mirror.begin()->first + 100;
+    long long hi = lo + 1000;
+    core.insert(lo, 0);
+    core.insert(hi, 0);
+    mirror.insert(make_pair(lo, 0));
+    mirror.insert(make_pair(hi, 0));
+    int inRange = distance(mirror.lower_bound(lo), mirror.upper_bound(hi));
+    mirror.erase(mirror.lower_bound(lo), mirror.upper_bound(hi));
+    result = result && (core.removeRange(lo, hi) == inRange) && (core.size() == (int)mirror.size());
+    result = result && (core.find(lo) == nullptr) && (core.find(hi) == nullptr) && (core.rank(hi) == (int)distance(mirror.begin(), mirror.lower_bound(hi)));
+    core.forEach([&](const CoreNode& node){
+        int leftHeight = ((node.getLeft() == nullptr) ? -1 : node.getLeft()->getHeight());
+        int rightHeight = ((node.getRight() == nullptr) ? -1 : node.getRight()->getHeight());
+        result = result && (leftHeight - rightHeight >= -1) && (leftHeight - rightHeight <= 1);
+    });
+
+    //a custom comparator reverses the order
+    TreeCore<long long, int, greater<long long> > reversed;
+    for (int i = 0; i < 100; i++){
+        reversed.insert(base + i, i);
+    }
+    result = result && (reversed.select(0)->getKey() == base + 99) && (reversed.rank(base) == 99) && !(reversed.insert(base, 0));
+    core.clear();
+    result = result && (core.size() == 0) && (core.root() == nullptr);
+
+    //Show's own kernels keep the drones balanced through the same removes and joins
+    for (int i = 0; i < 3000; i++){
+        show.insert(MINID + keyGen.getRandNum(), static_cast<LIGHTCOLOR>(i % 3));
+    }
+    show.removeRange(MINID + 1000, MINID + 2000);
+    result = result && balanceHelper(show.m_root) && countHelper(show.m_root) && binarySearchTest(result, show.m_root);
+    return result;
+}
+
+//testWavl
+//runs the same churn of inserts, removes, state changes, and mass retirements on a WAVL show and an AVL show
+//both must answer alike while the WAVL tree keeps its rank rules, then the two are compared on rotations and time
+bool Tester::testWavl(Show& show){
+    bool result = true;
+    Show avl;
+    show.setBalance(WAVL);
+    result = result && (show.getBalance() == WAVL) && (avl.getBalance() == AVL);
+    Random idGen(MINID, MINID + 40000);
+    Random opGen(0, 9);
+    opGen.setSeed(20);
+    long long avlBefore = DroneBalance::rotations();
+    long long wavlBefore = DroneWavl::rotations();
+    for (int round = 0; round < 10; round++){
+        for (int i = 0; i < 5000; i++){
+            int id = idGen.getRandNum();
+            int op = opGen.getRandNum();
+            if (op < 4){
+                LIGHTCOLOR type = static_cast<LIGHTCOLOR>(i % 3);
+                result = result && (show.insert(id, type) == avl.insert(id, type));
+            }
+            else if (op < 8){
+                result = result && (show.remove(id) == avl.remove(id));
+            }
+            else{
+                result = result && (show.setState(id, LIGHTOFF) == avl.setState(id, LIGHTOFF));
+            }
+        }
+        //mass retirements split and join the WAVL tree
+        int loId = idGen.getRandNum();
+        result = result && (show.removeRange(loId, loId + 500) == avl.removeRange(loId, loId + 500));
+        if (round % 3 == 2){
+            show.removeLightOff();
+            avl.removeLightOff();
+        }
+        result = result && (show.countDrones() == avl.countDrones()) && rankHelper(show.m_root) && countHelper(show.m_root);
+    }
+    long long avlRotations = DroneBalance::rotations() - avlBefore;
+    long long wavlRotations = DroneWavl::rotations() - wavlBefore;
+    result = result && binarySearchTest(result, show.m_root) && (wavlRotations < avlRotations);
+    result = result && (show.countDrones(LIGHTOFF) == avl.countDrones(LIGHTOFF)) && (show.rank(MINID + 20000) == avl.rank(MINID + 20000));
+    result = result && equal(show.begin(), show.end(), avl.begin(),
+                             [](const Drone& lhs, const Drone& rhs){return (lhs.getID() == rhs.getID()) && (lhs.getState() == rhs.getState());});
+    //a WAVL tree's rank, which bounds its height, is never more than twice the log of its size
+    result = result && (show.m_root->getHeight() <= 2 * log2(show.countDrones() + 1));
+
+    //an AVL copy of a WAVL show, and the show itself once switched back, are rebuilt as AVL trees
+    Show copy;
+    copy = show;
+    result = result && (copy.getBalance() == AVL) && balanceHelper(copy.m_root) && countHelper(copy.m_root);
+    Show wavlCopy;
+    wavlCopy.setBalance(WAVL);
+    wavlCopy = avl;
+    result = result && rankHelper(wavlCopy.m_root) && (wavlCopy.countDrones() == avl.countDrones());
+    show.setBalance(AVL);
+    result = result && balanceHelper(show.m_root) && countHelper(show.m_root) && (show.countDrones() == avl.countDrones());
+
+    //the same churn run alone on each kind of show, timed
+    double seconds[2];
+    long long rotations[2];
+    for (int mode = 0; mode < 2; mode++){
+        Show timed;
+        timed.setBalance((mode == 0) ? AVL : WAVL);
+        Random timedIds(MINID, MINID + 40000);
+        Random timedOps(0, 9);
+        timedOps.setSeed(20);
+        long long before = Show::rotationCount();
+        clock_t start = clock();
+        for (int i = 0; i < 100000; i++){
+            int id = timedIds.getRandNum();
+            int op = timedOps.getRandNum();
+            if (op < 5){
+                timed.insert(id);
+            }
+            else{
+                timed.remove(id);
+            }
+        }
+        seconds[mode] = (double)(clock() - start) / CLOCKS_PER_SEC;
+        rotations[mode] = Show::rotationCount() - before;
+    }
+    cout << "AVL: " << rotations[0] / 100000.0 << " rotations per op, " << 100000 / seconds[0] << " ops per second" << endl << "\t";
+    cout << "WAVL: " << rotations[1] / 100000.0 << " rotations per op, " << 100000 / seconds[1] << " ops per second" << endl << "\t";
+    result = result && (rotations[1] < rotations[0]);
+    return result;
+}
+
+//testAdaptive
+//replays a Zipfian trace of findDrone and setState calls on an adaptive show and an AVL show with the same drones
+//the adaptive tree must stay within its slack with correct heights and counters, and its hottest drones must sit higher
+bool Tester::testAdaptive(Show& show){
+    bool result = true;
+    Show avl;
+    show.setBalance(ADAPTIVE);
+    result = result && (show.getBalance() == ADAPTIVE);
+    Random idGen(MINID, MAXID);
+    vector<int> ids;
+    while (ids.size() < 50000){
+        int id = idGen.getRandNum();
+        if (show.insert(id) == INSERTED){
+            avl.insert(id);
+            ids.push_back(id);
+        }
+    }
+
+    //rank r of the trace is drawn with weight 1 / r, and the ranks go to drones in random order
+    vector<double> weights(ids.size());
+    for (unsigned int i = 0; i < weights.size(); i++){
+        weights[i] = 1.0 / (i + 1);
+    }
+    mt19937 generator(10);
+    shuffle(ids.begin(), ids.end(), generator);//the drones inserted first sit high in any tree, so they must not be the hot ones
+    discrete_distribution<int> zipf(weights.begin(), weights.end());
+    vector<int> trace(200000);
+    for (unsigned int i = 0; i < trace.size(); i++){
+        trace[i] = ids[zipf(generator)];
+    }
+    long long before = Show::rotationCount();
+    clock_t start = clock();
+    for (unsigned int i = 0; i < trace.size(); i++){
+        if (i % 4 == 0){
+            STATE state = ((i % 8 == 0) ? LIGHTOFF : LIGHTON);
+            result = result && (show.setState(trace[i], state) == avl.setState(trace[i], state));
+        }
+        else{
+            result = result && show.findDrone(trace[i]);
+        }
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    long long rotations = Show::rotationCount() - before;
+    result = result && balanceHelper(show.m_root, DroneRelaxed::slack) && (checkHeight(show.m_root) < 1000) && countHelper(show.m_root);
+    result = result && binarySearchTest(result, show.m_root) && (show.countDrones(LIGHTOFF) == avl.countDrones(LIGHTOFF));
+
+    //the 300 hottest drones are compared by their average depth in each tree
+    double adaptiveDepth = 0;
+    double avlDepth = 0;
+    for (int i = 0; i < 300; i++){
+        for (int tree = 0; tree < 2; tree++){
+            const Drone* curr = ((tree == 0) ? show.m_root : avl.m_root);
+            int depth = 0;
+            while (curr->getID() != ids[i]){
+                curr = ((ids[i] < curr->getID()) ? curr->getLeft() : curr->getRight());
+                depth++;
+            }
+            ((tree == 0) ? adaptiveDepth : avlDepth) += depth / 300.0;
+        }
+    }
+    cout << "hot drone depth " << avlDepth << " in AVL, " << adaptiveDepth << " adaptive, "
+         << (double)rotations / trace.size() << " rotations and " << seconds * 1e9 / trace.size() << " ns per access" << endl << "\t";
+    result = result && (adaptiveDepth < avlDepth);
+    result = result && (show.m_root->getHeight() < MAXDEPTH / 2);
+
+    //changes keep working within the slack, removeRange included
+    for (int i = 0; i < 20000; i++){
+        int id = idGen.getRandNum();
+        if (i % 2 == 0){
+            result = result && (show.insert(id) == avl.insert(id));
+        }
+        else{
+            result = result && (show.remove(id) == avl.remove(id));
+        }
+    }
+    result = result && (show.removeRange(MINID + 20000, MINID + 40000) == avl.removeRange(MINID + 20000, MINID + 40000));
+    show.removeLightOff();
+    avl.removeLightOff();
+    result = result && balanceHelper(show.m_root, DroneRelaxed::slack) && (checkHeight(show.m_root) < 1000) && countHelper(show.m_root);
+    result = result && equal(show.begin(), show.end(), avl.begin(),
+                             [](const Drone& lhs, const Drone& rhs){return lhs.getID() == rhs.getID();});
+
+    //going back to AVL, or copying into an AVL show, relinks the tree
+    Show copy;
+    copy = show;
+    result = result && balanceHelper(copy.m_root) && (copy.countDrones() == avl.countDrones());
+    show.setBalance(AVL);
+    result = result && balanceHelper(show.m_root) && (show.m_hits.empty()) && countHelper(show.m_root);
+    return result;
+}
+
+//testHotCache
+//toggles a few hot drones many times on a cached show and a plain one, checking that they agree and most toggles hit
+//then checks that every change that moves or frees drones empties the cache, so no stale path is ever used
+//and that slots never filled, or probed by IDs out of range, never answer for a drone
+bool Tester::testHotCache(Show& show){
+    bool result = true;
+    Show plain;
+
+    //a new cache has only empty slots, an ID out of range or one sharing a slot with a real drone must not match one
+    Show empty;
+    empty.enableHotCache(64);
+    result = result && !(empty.setState(0, LIGHTOFF)) && !(empty.setState(MINID, LIGHTOFF)) && !(empty.findDrone(MINID));
+    empty.insert(MINID + 64);
+    result = result && !(empty.setState(0, LIGHTOFF)) && !(empty.setState(MINID, LIGHTOFF)) && empty.setState(MINID + 64, LIGHTOFF);
+    result = result && !(empty.setState(MAXID + 64, LIGHTON)) && (empty.countDrones(LIGHTOFF) == 1);
+
+    show.enableHotCache(200);
+    result = result && (show.m_hotCache.size() == 256) && (show.cacheHits() == 0) && (show.cacheMisses() == 0);
+    Random idGen(MINID, MAXID);
+    vector<int> ids;
+    while (ids.size() < 20000){
+        int id = idGen.getRandNum();
+        LIGHTCOLOR type = static_cast<LIGHTCOLOR>(ids.size() % 3);
+        if (show.insert(id, type) == INSERTED){
+            plain.insert(id, type);
+            ids.push_back(id);
+        }
+    }
+
+    //a light sequence toggling 40 lead drones, timed on each show before the two are compared
+    Random hotGen(0, 39);
+    vector<int> sequence(200000);
+    for (unsigned int i = 0; i < sequence.size(); i++){
+        sequence[i] = ids[hotGen.getRandNum()];
+    }
+    double seconds[2];
+    for (int pass = 0; pass < 2; pass++){
+        Show& toggled = ((pass == 0) ? plain : show);
+        clock_t start = clock();
+        for (unsigned int i = 0; i < sequence.size(); i++){
+            toggled.setState(sequence[i], ((i % 2 == 0) ? LIGHTOFF : LIGHTON));
+        }
+        seconds[pass] = (double)(clock() - start) / CLOCKS_PER_SEC;
+    }
+    for (unsigned int i = 0; i < sequence.size(); i++){
+        STATE state = ((i % 3 == 0) ? LIGHTOFF : LIGHTON);
+        result = result && (show.setState(sequence[i], state) == plain.setState(sequence[i], state));
+    }
+    double hitRate = (double)show.cacheHits() / (show.cacheHits() + show.cacheMisses());
+    cout << "hit rate " << hitRate << ", " << seconds[1] * 1e9 / sequence.size() << " ns per toggle cached, "
+         << seconds[0] * 1e9 / sequence.size() << " ns uncached" << endl << "\t";
+    result = result && (hitRate > 0.9) && countHelper(show.m_root);
+    result = result && (show.countDrones(LIGHTOFF) == plain.countDrones(LIGHTOFF)) && (show.countDrones(RED, LIGHTOFF, MINID, MAXID) == plain.countDrones(RED, LIGHTOFF, MINID, MAXID));
+
+    //a removed drone is not found through its old slot, and a drone whose data moved on a remove is still changed correctly
+    int hot = ids[0];
+    result = result && show.findDrone(hot) && (show.remove(hot) == REMOVED) && !(show.findDrone(hot)) && !(show.setState(hot, LIGHTOFF));
+    const Drone* root = show.m_root;
+    int rootID = root->getID();
+    const Drone* successor = root->getRight();
+    while (successor->getLeft() != nullptr){
+        successor = successor->getLeft();
+    }
+    int successorID = successor->getID();
+    show.setState(successorID, LIGHTOFF);
+    show.setState(successorID, LIGHTON);
+    result = result && (show.remove(rootID) == REMOVED) && show.setState(successorID, LIGHTOFF) && countHelper(show.m_root);
+    plain.remove(hot);
+    plain.remove(rootID);
+    plain.setState(successorID, LIGHTOFF);
+    result = result && (show.countDrones(LIGHTOFF) == plain.countDrones(LIGHTOFF)) && (show.countDrones() == plain.countDrones());
+
+    //removeRange, compact, and clear each leave every slot stale
+    int id = ids[1];
+    show.setState(id, LIGHTOFF);
+    show.removeRange(id, id);
+    result = result && !(show.setState(id, LIGHTON)) && !(show.findDrone(id)) && countHelper(show.m_root);
+    id = ids[2];
+    show.setState(id, LIGHTOFF);
+    show.compact();
+    result = result && show.setState(id, LIGHTON) && countHelper(show.m_root);
+    show.setState(id, LIGHTOFF);
+    show.compactStep(100);
+    result = result && show.setState(id, LIGHTON) && countHelper(show.m_root);
+    while (!(show.compactStep(5000))){}
+    result = result && show.setState(id, LIGHTOFF) && countHelper(show.m_root);
+    show.removeLightOff();
+    result = result && !(show.findDrone(id)) && countHelper(show.m_root);
+
+    //the assignment operator keeps this cache, and must not answer with the old drones
+    id = ids[100];//not one of the toggled drones, so it is still on
+    show.findDrone(id);
+    show = plain;
+    result = result && (show.findDrone(id) == plain.findDrone(id)) && show.setState(id, LIGHTOFF) && countHelper(show.m_root);
+    show.clear();
+    result = result && !(show.findDrone(id)) && !(show.setState(id, LIGHTON));
+
+    //inline and adaptive shows reshape themselves, which also empties the cache
+    show.setInlineLimits(16, 8);
+    show.setBalance(ADAPTIVE);
+    for (int i = 0; i < 16; i++){
+        show.insert(MINID + 2 * i);
+    }
+    show.setState(MINID + 10, LIGHTOFF);
+    show.remove(MINID + 4);
+    result = result && show.setState(MINID + 10, LIGHTON) && (show.countDrones(LIGHTOFF) == 0) && countHelper(show.m_root);
+    show.insert(MINID + 100);
+    show.insert(MINID + 101);
+    for (int i = 0; i < 50; i++){
+        show.findDrone(MINID + 30);
+        show.setState(MINID + 30, ((i % 2 == 0) ? LIGHTOFF : LIGHTON));
+    }
+    result = result && !(show.isInline()) && countHelper(show.m_root) && (show.countDrones(LIGHTON) == show.countDrones());
+    show.disableHotCache();
+    result = result && show.m_hotCache.empty() && show.findDrone(MINID + 30);
+    return result;
+}
+
+//testRotationKernels
+//builds every shape of imbalanced node the kernels handle, on either side, including equally tall children
+//and checks that the kernels give exactly the tree the generic trinode restructure gives, then times the two
+bool Tester::testRotationKernels(Show& show){
+    bool result = true;
+    DronePool pool;//the gadgets are linked by arena index, so their drones come from a pool of their own
+    int nextID = MINID;
+    //perfect builds a perfect subtree of the given height, giving out IDs in order
+    function<Drone*(int)> perfect = [&](int height) -> Drone*{
+        if (height < 0){
+            return nullptr;
+        }
+        Drone* left = perfect(height - 1);
+        Drone* curr = pool.allocate(nextID, static_cast<LIGHTCOLOR>(nextID % 3), DEFAULT_STATE);
+        nextID++;
+        curr->setLeft(left);
+        curr->setRight(perfect(height - 1));
+        DroneBalance::update(curr);
+        return curr;
+    };
+    //shaped builds a subtree of the given height whose children are equal, taller on the left, or taller on the right
+    auto shaped = [&](int height, int variant) -> Drone*{
+        if ((height < 1) || (variant == 0)){
+            return perfect(height);
+        }
+        Drone* left = perfect((variant == 1) ? height - 1 : height - 2);
+        Drone* curr = pool.allocate(nextID++, DEFAULT_LIGHT, DEFAULT_STATE);
+        curr->setLeft(left);
+        curr->setRight(perfect((variant == 1) ? height - 2 : height - 1));
+        DroneBalance::update(curr);
+        return curr;
+    };
+    //gadget builds z with a short subtree of height h on one side, and on the other y with outer and inner subtrees
+    auto gadget = [&](bool leftHeavy, int h, int outerHeight, int innerHeight, int variant) -> Drone*{
+        Drone* lower = (leftHeavy ? perfect(outerHeight) : perfect(h));
+        Drone* first = pool.allocate(nextID++, DEFAULT_LIGHT, DEFAULT_STATE);
+        Drone* middle = shaped(innerHeight, variant);
+        Drone* second = pool.allocate(nextID++, DEFAULT_LIGHT, DEFAULT_STATE);
+        Drone* upper = (leftHeavy ? perfect(h) : perfect(outerHeight));
+        Drone* y = (leftHeavy ? first : second);
+        Drone* z = (leftHeavy ? second : first);
+        y->setLeft(leftHeavy ? lower : middle);
+        y->setRight(leftHeavy ? middle : upper);
+        DroneBalance::update(y);
+        z->setLeft(leftHeavy ? y : lower);
+        z->setRight(leftHeavy ? upper : y);
+        DroneBalance::update(z);
+        return z;
+    };
+
+    //every case agrees with the generic restructure
+    for (int side = 0; side < 2; side++){
+        for (int h = 0; h <= 2; h++){
+            int heights[3][2] = {{h + 1, h + 1}, {h + 1, h}, {h, h + 1}};
+            for (int shape = 0; shape < 3; shape++){
+                for (int variant = 0; variant < 3; variant++){
+                    pool.releaseAll();
+                    nextID = MINID;
+                    Drone* generic = gadget(side == 0, h, heights[shape][0], heights[shape][1], variant);
+                    nextID = MINID;
+                    Drone* direct = gadget(side == 0, h, heights[shape][0], heights[shape][1], variant);
+                    generic = referenceRestructure(generic);
+                    direct = DroneBalance::rebalance(direct);
+                    result = result && assignmentHelper(result, generic, direct) && balanceHelper(direct) && countHelper(direct);
+                    result = result && (checkHeight(direct) < 1000) && binarySearchTest(result, direct);
+                }
+            }
+        }
+    }
+
+    //the same 40000 single and double rotations, timed with each implementation
+    double seconds[2];
+    for (int pass = 0; pass < 2; pass++){
+        pool.releaseAll();
+        vector<Drone*> roots;
+        for (int i = 0; i < 40000; i++){
+            nextID = MINID;
+            roots.push_back(gadget(i % 2 == 0, 0, ((i % 4 < 2) ? 1 : 0), ((i % 4 < 2) ? 0 : 1), 0));
+        }
+        clock_t start = clock();
+        for (unsigned int i = 0; i < roots.size(); i++){
+            roots[i] = ((pass == 0) ? referenceRestructure(roots[i]) : DroneBalance::rebalance(roots[i]));
+        }
+        seconds[pass] = (double)(clock() - start) / CLOCKS_PER_SEC;
+        for (unsigned int i = 0; i < roots.size(); i += 997){
+            result = result && balanceHelper(roots[i]) && countHelper(roots[i]);
+        }
+    }
+    cout << seconds[0] * 1e9 / 40000 << " ns per generic restructure, " << seconds[1] * 1e9 / 40000 << " ns per direct kernel" << endl << "\t";
+
+    //a show balanced by the kernels stays an AVL tree through inserts and removes on both sides
+    Random idGen(MINID, MINID + 5000);
+    for (int i = 0; i < 20000; i++){
+        int id = idGen.getRandNum();
+        if (show.insert(id) == DUPLICATE){
+            show.remove(id);
+        }
+    }
+    result = result && balanceHelper(show.m_root) && (checkHeight(show.m_root) < 1000) && countHelper(show.m_root);
+    return result;
+}
+
+//testBurst
+//a burst keeps lookups and counters right while it runs and leaves a balanced tree behind, and it is timed against plain setup
+bool Tester::testBurst(Show& show){
+    bool result = true;
+    vector<int> ids;
+    for (int id = MINID; id < MINID + 60000; id++){
+        ids.push_back(id);
+    }
+    mt19937 generator(22);
+    shuffle(ids.begin(), ids.end(), generator);
+    function<int(const Drone*)> deepest = [&](const Drone* curr) -> int{
+        return ((curr == nullptr) ? 0 : 1 + max(deepest(curr->getLeft()), deepest(curr->getRight())));
+    };
+
+    //the same setup of 60000 inserts and 20000 removes, without and then with a burst
+    Show plain;
+    double seconds[2];
+    clock_t start = clock();
+    for (unsigned int i = 0; i < ids.size(); i++){
+        plain.insert(ids[i], static_cast<LIGHTCOLOR>(ids[i] % 3));
+    }
+    for (int i = 0; i < 20000; i++){
+        plain.remove(ids[i]);
+    }
+    seconds[0] = (double)(clock() - start) / CLOCKS_PER_SEC;
+    start = clock();
+    show.beginBurst();
+    for (unsigned int i = 0; i < ids.size(); i++){
+        show.insert(ids[i], static_cast<LIGHTCOLOR>(ids[i] % 3));
+    }
+    for (int i = 0; i < 20000; i++){
+        show.remove(ids[i]);
+    }
+    double burstSeconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    show.endBurst();
+    seconds[1] = burstSeconds + (double)(clock() - start) / CLOCKS_PER_SEC;
+    result = result && !show.inBurst() && balanceHelper(show.m_root) && (checkHeight(show.m_root) != 1000) && countHelper(show.m_root);
+    Show::const_iterator other = plain.begin();
+    for (Show::const_iterator it = show.begin(); it != show.end(); ++it, ++other){
+        result = result && (it->getID() == other->getID());
+    }
+    cout << seconds[0] * 1000 << " ms to set up with rebalancing, " << seconds[1] * 1000 << " ms with a burst" << endl << "\t";
+    result = result && (seconds[1] < seconds[0]);
+
+    //lookups by ID work on the marked tree, and reading a counter settles it without ending the burst
+    Show mirror;
+    mirror.beginBurst();
+    for (unsigned int i = 0; i < ids.size(); i++){
+        mirror.insert(ids[i], static_cast<LIGHTCOLOR>(ids[i] % 3));
+    }
+    for (int i = 0; i < 20000; i++){
+        mirror.remove(ids[i]);
+    }
+    for (unsigned int i = 0; i < ids.size(); i += 7){
+        result = result && (mirror.findDrone(ids[i]) == (i >= 20000));
+    }
+    result = result && (mirror.floor(MINID + 30000)->getID() == plain.floor(MINID + 30000)->getID());
+    result = result && (mirror.m_root->getHeight() == DIRTY_HEIGHT) && binarySearchTest(result, mirror.m_root);
+    result = result && (mirror.countDrones() == 40000) && (mirror.countDrones(BLUE) == plain.countDrones(BLUE));
+    result = result && mirror.inBurst() && countHelper(mirror.m_root) && balanceHelper(mirror.m_root);
+    for (unsigned int i = 0; i < ids.size(); i += 7){
+        mirror.remove(ids[i]);
+        plain.remove(ids[i]);
+    }
+    result = result && (mirror.rank(MINID + 30000) == plain.rank(MINID + 30000));
+    result = result && (mirror.select(12345)->getID() == plain.select(12345)->getID());
+
+    //ascending IDs would leave a chain without rebalancing, the burst keeps every path short anyway
+    Show sorted;
+    sorted.beginBurst();
+    for (int id = MINID; id < MINID + 30000; id++){
+        sorted.insert(id);
+    }
+    result = result && (deepest(sorted.m_root) <= MAXDEPTH / 2 + 1) && sorted.findDrone(MINID + 29999);
+    //a copy of a bursting show is settled, and ranges can be removed mid burst
+    Show copy;
+    copy = sorted;
+    result = result && !copy.inBurst() && balanceHelper(copy.m_root) && (copy.countDrones() == 30000);
+    result = result && (sorted.removeRange(MINID + 100, MINID + 199) == 100) && balanceHelper(sorted.m_root);
+    sorted.insert(MINID + 150);
+    sorted.endBurst();
+    result = result && balanceHelper(sorted.m_root) && countHelper(sorted.m_root) && (sorted.countDrones() == 29901);
+
+    //a WAVL burst settles into valid ranks, and later changes rebalance as usual
+    Show wavl;
+    wavl.setBalance(WAVL);
+    wavl.beginBurst();
+    for (int i = 0; i < 5000; i++){
+        wavl.insert(ids[i]);
+    }
+    for (int i = 0; i < 5000; i += 3){
+        wavl.remove(ids[i]);
+    }
+    wavl.endBurst();
+    result = result && rankHelper(wavl.m_root) && countHelper(wavl.m_root);
+    for (int i = 5000; i < 6000; i++){
+        wavl.insert(ids[i]);
+    }
+    result = result && rankHelper(wavl.m_root) && binarySearchTest(result, wavl.m_root);
+
+    //an adaptive show does not reshape on lookups mid burst, and settles within its slack
+    Show adaptive;
+    adaptive.setBalance(ADAPTIVE);
+    adaptive.beginBurst();
+    for (int i = 0; i < 5000; i++){
+        adaptive.insert(ids[i]);
+    }
+    for (int i = 0; i < 100; i++){
+        result = result && adaptive.findDrone(ids[4999]);
+    }
+    adaptive.endBurst();
+    result = result && balanceHelper(adaptive.m_root, DroneRelaxed::slack) && countHelper(adaptive.m_root);
+    return result;
+}
+
+//testFingerInsert
+//rising and falling IDs append through the fingers, hints land the drone right before them, and both are timed
+bool Tester::testFingerInsert(Show& show){
+    bool result = true;
+    //rising IDs past the largest, with the same rebalancing done by descents that end one step short of it
+    Show descended;
+    show.insert(MAXID);
+    descended.insert(MAXID);
+    double seconds[2];
+    clock_t start = clock();
+    for (int i = 0; i < 60000; i++){
+        descended.insert(MINID + i, static_cast<LIGHTCOLOR>(i % 3));
+    }
+    seconds[0] = (double)(clock() - start) / CLOCKS_PER_SEC;
+    show.remove(MAXID);
+    start = clock();
+    for (int i = 0; i < 60000; i++){
+        show.insert(MINID + i, static_cast<LIGHTCOLOR>(i % 3));
+    }
+    seconds[1] = (double)(clock() - start) / CLOCKS_PER_SEC;
+    cout << seconds[0] * 1e9 / 60000 << " ns per descending insert, " << seconds[1] * 1e9 / 60000 << " ns per append" << endl << "\t";
+    result = result && (seconds[1] < seconds[0]) && show.fingerValid(RIGHTSIDE) && (show.fingerEnd(RIGHTSIDE)->getID() == MINID + 59999);
+    result = result && balanceHelper(show.m_root) && (checkHeight(show.m_root) != 1000) && countHelper(show.m_root);
+    result = result && binarySearchTest(result, show.m_root) && (show.countDrones(GREEN) == 20000);
+
+    //falling IDs append on the left, and a change elsewhere only makes the next one descend again
+    Show falling;
+    for (int id = MINID + 5000; id >= MINID; id--){
+        result = result && (falling.insert(id) == INSERTED);
+        if ((id % 1000 == 0) && (id != MINID)){
+            falling.remove(id + 500);
+        }
+    }
+    result = result && falling.fingerValid(LEFTSIDE) && (falling.fingerEnd(LEFTSIDE)->getID() == MINID);
+    result = result && balanceHelper(falling.m_root) && countHelper(falling.m_root) && (falling.countDrones() == 4997);
+    result = result && (falling.insert(MINID) == DUPLICATE) && (falling.insert(MINID - 1) == INVALID);
+
+    //hints, with end using the finger, and a hint the drone does not belong before falling back to a normal insert
+    Show hinted;
+    Show plain;
+    for (int id = MINID; id < MINID + 3000; id += 3){
+        result = result && (hinted.insert(hinted.end(), Drone(id, BLUE)) == INSERTED);
+        plain.insert(id, BLUE);
+    }
+    for (int id = MINID + 1; id < MINID + 3000; id += 3){
+        result = result && (hinted.insert(hinted.lower_bound(id), Drone(id, RED, LIGHTOFF)) == INSERTED);
+        plain.insert(id, RED, LIGHTOFF);
+    }
+    result = result && (hinted.insert(hinted.begin(), Drone(MINID + 2, GREEN)) == INSERTED);
+    result = result && (hinted.insert(hinted.end(), Drone(MINID + 5, GREEN)) == INSERTED);
+    result = result && (hinted.insert(hinted.lower_bound(MINID + 6), Drone(MINID + 6)) == DUPLICATE);
+    result = result && (hinted.insert(hinted.end(), Drone(MAXID + 1)) == INVALID);
+    result = result && (hinted.insert(show.begin(), Drone(MINID + 8)) == INSERTED);
+    plain.insert(MINID + 2, GREEN);
+    plain.insert(MINID + 5, GREEN);
+    plain.insert(MINID + 8);
+    result = result && balanceHelper(hinted.m_root) && countHelper(hinted.m_root) && (hinted.countDrones() == plain.countDrones());
+    Show::const_iterator other = plain.begin();
+    for (Show::const_iterator it = hinted.begin(); it != hinted.end(); ++it, ++other){
+        result = result && (it->getID() == other->getID()) && (it->getType() == other->getType()) && (it->getState() == other->getState());
+    }
+    result = result && (hinted.countDrones(RED, LIGHTOFF, MINID, MAXID) == 1000);
+
+    //every balancing mode, bursts, indexes, and inline shows append the same way
+    BALANCE modes[3] = {AVL, WAVL, ADAPTIVE};
+    for (int m = 0; m < 3; m++){
+        Show mode;
+        mode.setBalance(modes[m]);
+        mode.enableIndexes();
+        mode.setInlineLimits(16, 8);
+        for (int i = 0; i < 2000; i++){
+            mode.insert(MINID + 3000 + i, static_cast<LIGHTCOLOR>(i % 3));
+            mode.insert(MINID + 2999 - i, static_cast<LIGHTCOLOR>(i % 3));
+            if (i == 1000){
+                mode.beginBurst();
+            }
+        }
+        mode.endBurst();
+        int numBlue = 0;
+        mode.forEachMatching(BLUE, [&](const Drone&){numBlue++;});
+        result = result && (numBlue == mode.countDrones(BLUE)) && (mode.countDrones() == 4000) && countHelper(mode.m_root);
+        result = result && ((modes[m] == WAVL) ? rankHelper(mode.m_root) : balanceHelper(mode.m_root, (modes[m] == AVL) ? 1 : DroneRelaxed::slack));
+    }
+    return result;
+}
+
+//testRangeUpdates
+//range updates and recolors match the same changes made one drone at a time, reads and later changes push their tags down,
+//the bitmaps move whole ranges between sets, and one range update is timed against the setState calls it replaces
+bool Tester::testRangeUpdates(Show& show){
+    bool result = true;
+    //a random fleet, with a copy whose drones are changed one at a time
+    mt19937 generator(29);
+    Show plain;
+    for (int i = 0; i < 20000; i++){
+        int id = MINID + generator() % (MAXID - MINID + 1);
+        LIGHTCOLOR type = static_cast<LIGHTCOLOR>(generator() % 3);
+        STATE state = static_cast<STATE>(generator() % 2);
+        show.insert(id, type, state);
+        plain.insert(id, type, state);
+    }
+    for (int round = 0; round < 300; round++){
+        int lo = MINID + generator() % (MAXID - MINID + 1);
+        int hi = lo + generator() % 20000;
+        LIGHTCOLOR type = static_cast<LIGHTCOLOR>(generator() % 3);
+        STATE state = static_cast<STATE>(generator() % 2);
+        vector<Drone> changed;
+        if (round % 3 == 0){
+            show.setStateRange(lo, hi, state);
+            plain.forEachInRange(lo, hi, [&](const Drone& curr){changed.push_back(Drone(curr.getID(), curr.getType(), state));});
+        }
+        else if (round % 3 == 1){
+            show.setTypeRange(lo, hi, type);
+            plain.forEachInRange(lo, hi, [&](const Drone& curr){changed.push_back(Drone(curr.getID(), type, curr.getState()));});
+        }
+        else{
+            LIGHTCOLOR from = static_cast<LIGHTCOLOR>(generator() % 3);
+            show.recolor(from, type);
+            for (const Drone& curr : plain){
+                if (curr.getType() == from){
+                    changed.push_back(Drone(curr.getID(), type, curr.getState()));
+                }
+            }
+        }
+        for (unsigned int i = 0; i < changed.size(); i++){
+            plain.remove(changed[i].getID());
+            plain.insert(changed[i]);
+        }
+        //inserts and removes in between have to push the tags on their paths before moving anything
+        for (int i = 0; i < 20; i++){
+            int id = MINID + generator() % (MAXID - MINID + 1);
+            if (i % 2 == 0){
+                show.insert(id, type, state);
+                plain.insert(id, type, state);
+            }
+            else{
+                const Drone* next = plain.ceiling(id);
+                if (next != nullptr){
+                    id = next->getID();
+                    show.remove(id);
+                    plain.remove(id);
+                }
+            }
+        }
+        int k = generator() % plain.countDrones();
+        result = result && (show.select(k)->getType() == plain.select(k)->getType()) && (show.select(k)->getState() == plain.select(k)->getState());
+        result = result && (show.countDrones(type) == plain.countDrones(type)) && (show.countDrones(state) == plain.countDrones(state));
+        result = result && (show.countDrones(type, state, lo, hi) == plain.countDrones(type, state, lo, hi));
+    }
+    Show::const_iterator other = plain.begin();
+    for (Show::const_iterator it = show.begin(); it != show.end(); ++it, ++other){
+        result = result && (it->getID() == other->getID()) && (it->getType() == other->getType()) && (it->getState() == other->getState());
+    }
+    //a full iteration passes every drone, so no tag is left anywhere
+    result = result && (other == plain.end()) && countHelper(show.m_root) && balanceHelper(show.m_root);
+    result = result && binarySearchTest(result, show.m_root) && (checkHeight(show.m_root) != 1000);
+
+    //one range update against a setState per drone
+    Show timed;
+    Show perDrone;
+    for (int i = 0; i < 80000; i++){
+        timed.insert(MINID + i, static_cast<LIGHTCOLOR>(i % 3));
+        perDrone.insert(MINID + i, static_cast<LIGHTCOLOR>(i % 3));
+    }
+    double seconds[2];
+    clock_t start = clock();
+    for (int id = MINID + 10000; id < MINID + 70000; id++){
+        perDrone.setState(id, LIGHTOFF);
+    }
+    seconds[0] = (double)(clock() - start) / CLOCKS_PER_SEC;
+    start = clock();
+    timed.setStateRange(MINID + 10000, MINID + 69999, LIGHTOFF);
+    seconds[1] = (double)(clock() - start) / CLOCKS_PER_SEC;
+    cout << seconds[0] * 1e6 << " us for 60000 setState calls, " << seconds[1] * 1e6 << " us for one setStateRange" << endl << "\t";
+    result = result && (seconds[1] < seconds[0]) && (timed.countDrones(LIGHTOFF) == 60000);
+    result = result && (timed.countDrones(GREEN, LIGHTOFF, MINID, MINID + 39999) == 10000) && (timed.countDrones(RED, LIGHTON, MINID + 70000, MAXID) == 3333);
+
+    //invalid arguments change nothing, and a range is bounded to the valid IDs
+    timed.setStateRange(MINID, MAXID, static_cast<STATE>(5));
+    timed.setTypeRange(MAXID, MINID, BLUE);
+    timed.recolor(RED, static_cast<LIGHTCOLOR>(-1));
+    result = result && (timed.countDrones(LIGHTOFF) == 60000) && (timed.countDrones(BLUE) == 26666);
+    timed.setTypeRange(0, 2 * MAXID, BLUE);
+    result = result && (timed.countDrones(BLUE) == 80000) && (timed.countDrones(BLUE, LIGHTON, MINID, MAXID) == 20000);
+
+    //WAVL and adaptive shows with indexes, starting inline and then updated during a burst
+    BALANCE modes[2] = {WAVL, ADAPTIVE};
+    for (int m = 0; m < 2; m++){
+        Show mode;
+        mode.setBalance(modes[m]);
+        mode.enableIndexes();
+        mode.setInlineLimits(32, 16);
+        for (int i = 0; i < 24; i++){
+            mode.insert(MINID + 2 * i, static_cast<LIGHTCOLOR>(i % 3));
+        }
+        mode.setTypeRange(MINID + 10, MINID + 29, GREEN);
+        result = result && mode.isInline() && (mode.countDrones(GREEN) == 15) && (mode.countDrones(GREEN, LIGHTON, MINID, MINID + 9) == 2);
+        mode.beginBurst();
+        for (int i = 24; i < 5000; i++){
+            mode.insert(MINID + 2 * i, static_cast<LIGHTCOLOR>(i % 3));
+            if (i % 1000 == 0){
+                mode.setStateRange(MINID, MINID + 2 * i, LIGHTOFF);
+                mode.recolor(GREEN, RED);
+            }
+        }
+        result = result && mode.findDrone(MINID + 4000) && (mode.countDrones(LIGHTOFF) == 4001) && (mode.countDrones(GREEN) == 333);
+        mode.setStateRange(MINID + 1000, MINID + 2999, LIGHTON);
+        mode.endBurst();
+        mode.recolor(BLUE, GREEN);
+        int numOn = 0;
+        int numGreen = 0;
+        mode.forEachMatching(LIGHTON, [&](const Drone& curr){numOn += (curr.getState() == LIGHTON);});
+        mode.forEachMatching(GREEN, [&](const Drone& curr){numGreen += (curr.getType() == GREEN);});
+        result = result && (numOn == mode.countDrones(LIGHTON)) && (numOn == 1999) && (numGreen == mode.countDrones(GREEN));
+        int numDrones = 0;
+        for (Show::const_iterator it = mode.begin(); it != mode.end(); ++it){
+            numDrones++;
+        }
+        result = result && (numDrones == 5000) && countHelper(mode.m_root);
+        result = result && ((modes[m] == WAVL) ? rankHelper(mode.m_root) : balanceHelper(mode.m_root, DroneRelaxed::slack));
+    }
+
+    //moveRange across array and bitmap containers, checked against a plain table
+    DroneBitmap sparse;
+    DroneBitmap dense;
+    vector<char> inSparse(300000, 0);
+    vector<char> inDense(300000, 0);
+    for (int id = 0; id < 300000; id++){
+        if ((id >> 16 == 1) ? (id % 2 == 0) : (generator() % 50 == 0)){
+            dense.add(id);
+            inDense[id] = 1;
+        }
+        else if (generator() % 20 == 0){
+            sparse.add(id);
+            inSparse[id] = 1;
+        }
+    }
+    for (int round = 0; round < 40; round++){
+        int lo = generator() % 300000;
+        int hi = lo + generator() % 100000;
+        bool fromDense = (round % 2 == 0);
+        (fromDense ? dense : sparse).moveRange((fromDense ? sparse : dense), lo, hi);
+        for (int id = lo; (id <= hi) && (id < 300000); id++){
+            vector<char>& source = (fromDense ? inDense : inSparse);
+            (fromDense ? inSparse : inDense)[id] |= source[id];
+            source[id] = 0;
+        }
+    }
+    int numSparse = 0;
+    int numDense = 0;
+    for (int id = 0; id < 300000; id++){
+        result = result && (sparse.contains(id) == (bool)inSparse[id]) && (dense.contains(id) == (bool)inDense[id]);
+        numSparse += inSparse[id];
+        numDense += inDense[id];
+    }
+    int numListed = 0;
+    int prev = -1;
+    sparse.forEach([&](int id){result = result && (id > prev); prev = id; numListed++;});
+    result = result && (sparse.cardinality() == numSparse) && (dense.cardinality() == numDense) && (numListed == numSparse);
+    return result;
+}
+
+//testBatchApply
+//batches of mixed ops, with repeated and invalid IDs, leave the same tree and report the same results as the single calls,
+//in every balancing mode and with indexes, inline shows, and bursts, and a large batch is timed against the single calls
+bool Tester::testBatchApply(Show& show){
+    bool result = true;
+    mt19937 generator(41);
+    BALANCE modes[3] = {AVL, WAVL, ADAPTIVE};
+    for (int m = 0; m < 3; m++){
+        Show batched;
+        Show single;
+        batched.setBalance(modes[m]);
+        single.setBalance(modes[m]);
+        batched.enableIndexes();
+        batched.setInlineLimits(32, 16);
+        for (int round = 0; round < 40; round++){
+            //IDs are drawn from a narrow range, so one batch often holds several ops on the same ID
+            int numOps = ((round < 4) ? 10 : 1 + generator() % 3000);
+            vector<DroneOp> ops(numOps);
+            for (int i = 0; i < numOps; i++){
+                ops[i].kind = static_cast<OPKIND>(generator() % 3);
+                ops[i].id = MINID - 5 + generator() % 6000;
+                ops[i].type = static_cast<LIGHTCOLOR>(generator() % 4);
+                ops[i].state = static_cast<STATE>(generator() % 2);
+            }
+            if (round == 20){
+                batched.beginBurst();
+            }
+            bool done[3000];
+            batched.apply(ops.data(), numOps, done);
+            for (int i = 0; i < numOps; i++){
+                bool expected;
+                if (ops[i].kind == INSERTOP){
+                    expected = (single.insert(ops[i].id, ops[i].type, ops[i].state) == INSERTED);
+                }
+                else if (ops[i].kind == REMOVEOP){
+                    expected = (single.remove(ops[i].id) == REMOVED);
+                }
+                else{
+                    expected = single.setState(ops[i].id, ops[i].state);
+                }
+                result = result && (done[i] == expected);
+            }
+            result = result && (batched.countDrones() == single.countDrones()) && (batched.countDrones(BLUE, LIGHTOFF, MINID, MAXID) == single.countDrones(BLUE, LIGHTOFF, MINID, MAXID));
+            if (round == 3){
+                result = result && batched.isInline();
+            }
+        }
+        batched.endBurst();
+        Show::const_iterator other = single.begin();
+        for (Show::const_iterator it = batched.begin(); it != batched.end(); ++it, ++other){
+            result = result && (it->getID() == other->getID()) && (it->getType() == other->getType()) && (it->getState() == other->getState());
+        }
+        int numOff = 0;
+        batched.forEachMatching(LIGHTOFF, [&](const Drone& curr){numOff += (curr.getState() == LIGHTOFF);});
+        result = result && (other == single.end()) && (numOff == single.countDrones(LIGHTOFF)) && countHelper(batched.m_root);
+        result = result && ((modes[m] == WAVL) ? rankHelper(batched.m_root) : balanceHelper(batched.m_root, (modes[m] == AVL) ? 1 : DroneRelaxed::slack));
+    }
+
+    //an empty batch changes nothing, and a batch into an empty show builds it
+    show.apply(nullptr, 0, nullptr);
+    vector<DroneOp> fill(5000);
+    bool filled[5000];
+    for (int i = 0; i < 5000; i++){
+        fill[i].kind = INSERTOP;
+        fill[i].id = MAXID - 2 * i;
+        fill[i].type = GREEN;
+        fill[i].state = LIGHTOFF;
+    }
+    show.apply(fill.data(), 5000, filled);
+    result = result && (show.countDrones(GREEN) == 5000) && filled[0] && filled[4999] && balanceHelper(show.m_root) && countHelper(show.m_root);
+    result = result && binarySearchTest(result, show.m_root) && (checkHeight(show.m_root) != 1000);
+
+    //a large batch against the same ops one call at a time
+    Show timed;
+    Show perOp;
+    for (int i = 0; i < 80000; i++){
+        timed.insert(MINID + i, static_cast<LIGHTCOLOR>(i % 3));
+        perOp.insert(MINID + i, static_cast<LIGHTCOLOR>(i % 3));
+    }
+    vector<DroneOp> ops(40000);
+    for (int i = 0; i < 40000; i++){
+        ops[i].kind = static_cast<OPKIND>(i % 3);
+        ops[i].id = MINID + generator() % (MAXID - MINID + 1);
+        ops[i].type = RED;
+        ops[i].state = LIGHTOFF;
+    }
+    vector<char> perOpDone(40000);
+    double seconds[2];
+    clock_t start = clock();
+    for (int i = 0; i < 40000; i++){
+        if (ops[i].kind == INSERTOP){
+            perOpDone[i] = (perOp.insert(ops[i].id, ops[i].type, ops[i].state) == INSERTED);
+        }
+        else if (ops[i].kind == REMOVEOP){
+            perOpDone[i] = (perOp.remove(ops[i].id) == REMOVED);
+        }
+        else{
+            perOpDone[i] = perOp.setState(ops[i].id, ops[i].state);
+        }
+    }
+    seconds[0] = (double)(clock() - start) / CLOCKS_PER_SEC;
+    bool* batchDone = new bool[40000];
+    start = clock();
+    timed.apply(ops.data(), 40000, batchDone);
+    seconds[1] = (double)(clock() - start) / CLOCKS_PER_SEC;
+    cout << seconds[0] * 1e9 / 40000 << " ns per single call, " << seconds[1] * 1e9 / 40000 << " ns per op in one batch" << endl << "\t";
+    for (int i = 0; i < 40000; i++){
+        result = result && (batchDone[i] == (bool)perOpDone[i]);
+    }
+    delete[] batchDone;
+    result = result && (seconds[1] < seconds[0]) && (timed.countDrones() == perOp.countDrones()) && (timed.countDrones(LIGHTOFF) == perOp.countDrones(LIGHTOFF));
+    result = result && balanceHelper(timed.m_root) && countHelper(timed.m_root);
+    return result;
+}
+
+//randomFill
+//copied from driver, fills show with 15 random elements
+bool Tester::randomFill(Show& show){
+    bool result = true;
+    Random idGen(MINID,MAXID);
+    Random typeGen(0,2); // there are three colors
+    int ID = 0;
+    for(int i = 0; i < NORMAL_CASE; i++){
+        ID = idGen.getRandNum();
+        Drone drone(ID,static_cast<LIGHTCOLOR>(typeGen.getRandNum()));
+        show.insert(drone);
+        result = result && (show.findDrone(ID));
+    }
+
+    return result; 
+}
+
+//time complexity helper functions
+
+//insertTimeMeasurement
+//displays the time complexity of insertion
+double Tester::insertTimeMeasurement(Show& show, int addDrones){
+    double T = 0.0;//stores running times
+    clock_t start, stop;//stores the clock ticks while running the program
+    Random idGen(MINID,MAXID);
+    int ID;
+
+    start = clock();
+    // the algorithm to be measured
+    //inserts the drones into the show
+    for (int i = 0; i < addDrones; i++){
+        ID = idGen.getRandNum();
+        Drone drone(ID);
+        show.insert(drone);
+    }
+    stop = clock();
+    T = stop - start;//number of clock ticks the algorithm took
+    double measureTime = T/CLOCKS_PER_SEC;//time in seconds
+    return measureTime;
+}
+
+//removeTimeMeasurement
+//displays the time complexity of removal
+double Tester::removeTimeMeasurement(Show& show, int numToBeRemoved){
+    double T = 0.0;//stores running times
+    clock_t start, stop;//stores the clock ticks while running the program
+
+    start = clock();
+    // the algorithm to be measured
+    //removes the drones from the show
+    for (int i = 0; i < numToBeRemoved; i++){
+       show.remove(i + MINID);
     }
     stop = clock();
     T = stop - start;//number of clock ticks the algorithm took
@@ -1864,7 +4400,7 @@ bool Tester::changeID(Show& show, int id, int newID){
         }
         //else, id is equal to curr->getID(), meaning that the ID will be changed
         else{
-            curr->m_id = newID;
+            curr->setID(newID);
             return true;
         }
     }
@@ -1925,4 +4461,150 @@ bool Tester::assignmentHelper(bool result, const Drone* lhsPtr, const Drone* rhs
     else{
         return result && false; //else, result and false is returned
     }  
-}
\ No newline at end of file
+}
+
+//countHelper
+//checks that every drone's counters equal its children's counters plus itself
+bool Tester::countHelper(const Drone* curr){
+    if (curr == nullptr){
+        return true;
+    }
+    //for loops compare each color and state with what the children and the drone itself add up to
+    for (int i = 0; i < NUMCOLORS; i++){
+        for (int j = 0; j < NUMSTATES; j++){
+            LIGHTCOLOR color = static_cast<LIGHTCOLOR>(i);
+            STATE state = static_cast<STATE>(j);
+            int expected = (((curr->getType() == color) && (curr->getState() == state)) ? 1 : 0);
+            expected += ((curr->getLeft() == nullptr) ? 0 : curr->getLeft()->getCount(color, state));
+            expected += ((curr->getRight() == nullptr) ? 0 : curr->getRight()->getCount(color, state));
+            if (curr->getCount(color, state) != expected){
+                return false;
+            }
+        }
+    }
+    //size is checked the same way
+    int size = 1 + ((curr->getLeft() == nullptr) ? 0 : curr->getLeft()->getSize());
+    size += ((curr->getRight() == nullptr) ? 0 : curr->getRight()->getSize());
+    if (curr->getSize() != size){
+        return false;
+    }
+    return countHelper(curr->getLeft()) && countHelper(curr->getRight());
+}
+
+//balanceHelper
+//checks that the heights of every drone's children differ by at most slack, one for AVL
+bool Tester::balanceHelper(const Drone* curr, int slack){
+    if (curr == nullptr){
+        return true;
+    }
+    int leftHeight = ((curr->getLeft() == nullptr) ? -1 : curr->getLeft()->getHeight());
+    int rightHeight = ((curr->getRight() == nullptr) ? -1 : curr->getRight()->getHeight());
+    if ((leftHeight - rightHeight > slack) || (rightHeight - leftHeight > slack)){
+        return false;
+    }
+    return balanceHelper(curr->getLeft(), slack) && balanceHelper(curr->getRight(), slack);
+}
+
+//bucketHelper
+//checks that every bucket is non-empty and sorted, follows the previous bucket, is balanced with a correct height, and sums its counts
+bool Tester::bucketHelper(const DroneBucket* curr, int& prevID){
+    if (curr == nullptr){
+        return true;
+    }
+    if (!bucketHelper(curr->getLeft(), prevID) || (curr->getNumDrones() == 0)){
+        return false;
+    }
+    for (int i = 0; i < curr->getNumDrones(); i++){
+        if (curr->m_ids[i] <= prevID){
+            return false;
+        }
+        prevID = curr->m_ids[i];
+    }
+    int leftHeight = ((curr->getLeft() == nullptr) ? -1 : curr->getLeft()->getHeight());
+    int rightHeight = ((curr->getRight() == nullptr) ? -1 : curr->getRight()->getHeight());
+    if ((leftHeight - rightHeight > 1) || (rightHeight - leftHeight > 1)
+        || (curr->getHeight() != 1 + ((leftHeight > rightHeight) ? leftHeight : rightHeight))){
+        return false;
+    }
+    //the size and counts are the bucket's own drones plus its children's
+    int size = curr->getNumDrones() + ((curr->getLeft() == nullptr) ? 0 : curr->getLeft()->getSize())
+               + ((curr->getRight() == nullptr) ? 0 : curr->getRight()->getSize());
+    int numOff = 0;
+    for (int color = RED; color <= BLUE; color++){
+        numOff += curr->getCount(static_cast<LIGHTCOLOR>(color), LIGHTOFF);
+    }
+    int ownOff = 0;
+    for (int i = 0; i < curr->getNumDrones(); i++){
+        ownOff += (curr->m_states[i] == LIGHTOFF);
+    }
+    int childOff = 0;
+    const DroneBucket* children[2] = {curr->getLeft(), curr->getRight()};
+    for (int c = 0; c < 2; c++){
+        for (int color = RED; (children[c] != nullptr) && (color <= BLUE); color++){
+            childOff += children[c]->getCount(static_cast<LIGHTCOLOR>(color), LIGHTOFF);
+        }
+    }
+    if ((curr->getSize() != size) || (numOff != ownOff + childOff)){
+        return false;
+    }
+    return bucketHelper(curr->getRight(), prevID);
+}
+
+//rankHelper
+//checks that every drone's rank is one or two above each child's, with a missing child at -1, and that leaves have rank 0
+bool Tester::rankHelper(const Drone* curr){
+    if (curr == nullptr){
+        return true;
+    }
+    int leftRank = ((curr->getLeft() == nullptr) ? -1 : curr->getLeft()->getHeight());
+    int rightRank = ((curr->getRight() == nullptr) ? -1 : curr->getRight()->getHeight());
+    int leftDifference = curr->getHeight() - leftRank;
+    int rightDifference = curr->getHeight() - rightRank;
+    if ((leftDifference < 1) || (leftDifference > 2) || (rightDifference < 1) || (rightDifference > 2)){
+        return false;
+    }
+    if ((curr->getLeft() == nullptr) && (curr->getRight() == nullptr) && (curr->getHeight() != 0)){
+        return false;
+    }
+    return rankHelper(curr->getLeft()) && rankHelper(curr->getRight());
+}
+
+//referenceRestructure
+//the generic trinode restructure: y and x are found with two tallest child searches, sorted into a, b, and c by ID,
+//and then the four subtrees are picked, with the same tie rule as the kernels
+Drone* Tester::referenceRestructure(Drone* zDrone){
+    Drone* yDrone = ((DroneBalance::heightOf(zDrone->getLeft()) < DroneBalance::heightOf(zDrone->getRight())) ? zDrone->getRight() : zDrone->getLeft());
+    Drone* xDrone = ((DroneBalance::heightOf(yDrone->getLeft()) < DroneBalance::heightOf(yDrone->getRight())) ? yDrone->getRight() : yDrone->getLeft());
+    if ((yDrone == zDrone->getRight()) && (DroneBalance::heightOf(yDrone->getLeft()) == DroneBalance::heightOf(yDrone->getRight()))
+        && (DroneBalance::heightOf(xDrone->getRight()) != yDrone->getHeight() - 2)){
+        xDrone = yDrone->getRight();
+    }
+    Drone* trio[3] = {xDrone, yDrone, zDrone};
+    sort(trio, trio + 3, [](const Drone* lhs, const Drone* rhs){return lhs->getID() < rhs->getID();});
+    Drone* a = trio[0];
+    Drone* b = trio[1];
+    Drone* c = trio[2];
+    Drone* subtree[4];
+    if ((zDrone == a) && (yDrone == b)){
+        subtree[0] = zDrone->getLeft(); subtree[1] = yDrone->getLeft(); subtree[2] = xDrone->getLeft(); subtree[3] = xDrone->getRight();
+    }
+    else if ((zDrone == a) && (yDrone == c)){
+        subtree[0] = zDrone->getLeft(); subtree[1] = xDrone->getLeft(); subtree[2] = xDrone->getRight(); subtree[3] = yDrone->getRight();
+    }
+    else if ((zDrone == c) && (yDrone == b)){
+        subtree[0] = xDrone->getLeft(); subtree[1] = xDrone->getRight(); subtree[2] = yDrone->getRight(); subtree[3] = zDrone->getRight();
+    }
+    else{
+        subtree[0] = yDrone->getLeft(); subtree[1] = xDrone->getLeft(); subtree[2] = xDrone->getRight(); subtree[3] = zDrone->getRight();
+    }
+    b->setLeft(a);
+    b->setRight(c);
+    a->setLeft(subtree[0]);
+    a->setRight(subtree[1]);
+    c->setLeft(subtree[2]);
+    c->setRight(subtree[3]);
+    DroneBalance::update(a);
+    DroneBalance::update(c);
+    DroneBalance::update(b);
+    return b;
+}
@@ -8,60 +8,399 @@
  **
  ** This file defines the functions laid out in show.h. Every function is initialized here
  **
- ** All functions were created by William Whatley excluding dumpTree and dump, whch was provided in the project
+ ** The original functions were created by William Whatley excluding dumpTree and dump, which were provided in the project
+ ** Functions added since then were written later by the Show maintainers
 *****************************/
 
 #include "show.h"
+#include <algorithm>
+#include <cstdlib>
+#include <sys/mman.h>
 
 //Default constructor
 //Sets m_root to nullptr
 Show::Show(){
     m_root = nullptr;
+    m_inlineMode = false;
+    m_numInline = 0;
+    m_promoteAbove = 0;
+    m_demoteBelow = 0;
+    m_inline = nullptr;
+    m_inlineBlock = 0;
+    m_compactCursor = NOT_COMPACTING;
+    m_indexed = false;
+    m_balance = AVL;
+    m_cacheEpoch = 0;
+    m_cacheHits = 0;
+    m_cacheMisses = 0;
+    m_burst = false;
+    for (int i = 0; i < 2; i++){
+        m_fingers[i].depth = 0;
+        m_fingers[i].epoch = 0;
+    }
 }
 
 //Destructor
 //Calls upon clear to entirely clear and delete the object
 Show::~Show(){
     clear(); //clear called
+    //the inline array is an arena block of its own, outside the pool
+    if (m_inline != nullptr){
+        DronePool::giveBlock(m_inline, m_inlineBlock);
+    }
+}
+
+//reserve
+//preallocates room for numDrones drones, so later inserts do not have to grow the pool
+void Show::reserve(int numDrones){
+    m_pool.reserve(numDrones);
+}
+
+//loadRoster
+//drops invalid drones, sorts and dedupes the rest, merges them with the tree, and rebuilds it balanced in O(n)
+//for a duplicate ID the drone already in the tree wins, then the first one in the roster, just like insert
+int Show::loadRoster(vector<Drone>& roster, int numThreads){
+    if (m_inlineMode){
+        promote();
+    }
+    //for loop keeps only the drones which insert would accept
+    int numValid = 0;
+    for (unsigned int i = 0; i < roster.size(); i++){
+        int id = roster[i].getID();
+        LIGHTCOLOR type = roster[i].getType();
+        STATE state = roster[i].getState();
+        if ((id >= MINID) && (id <= MAXID) && ((type == RED) || (type == GREEN) || (type == BLUE))
+            && ((state == LIGHTON) || (state == LIGHTOFF))){
+            roster[numValid++] = roster[i];
+        }
+    }
+    roster.resize(numValid);
+
+    //stable sort keeps duplicates in their original order, so unique keeps the first of each
+    stable_sort(roster.begin(), roster.end(),
+        [](const Drone& lhs, const Drone& rhs){return lhs.getID() < rhs.getID();});
+    roster.erase(unique(roster.begin(), roster.end(),
+        [](const Drone& lhs, const Drone& rhs){return lhs.getID() == rhs.getID();}), roster.end());
+
+    //the existing drones are listed in order so both sorted lists can be merged
+    vector<Drone*> existing;
+    existing.reserve(m_pool.inUse());
+    flattenInorder(m_root, existing);
+    m_pool.reserve(existing.size() + roster.size());
+
+    vector<Drone*> nodes;
+    nodes.reserve(existing.size() + roster.size());
+    unsigned int i = 0;
+    unsigned int j = 0;
+    int added = 0;
+    //while loop merges the two lists, allocating only for drones which are not already in the tree
+    while ((i < existing.size()) || (j < roster.size())){
+        if ((j == roster.size()) || ((i < existing.size()) && (existing[i]->getID() < roster[j].getID()))){
+            nodes.push_back(existing[i++]);
+        }
+        else if ((i < existing.size()) && (existing[i]->getID() == roster[j].getID())){
+            j++; //duplicate, the drone already in the tree is kept
+        }
+        else{
+            nodes.push_back(m_pool.allocate(roster[j].getID(), roster[j].getType(), roster[j].getState()));
+            if (m_indexed){
+                indexDrone(roster[j].getID(), roster[j].getType(), roster[j].getState());
+            }
+            j++;
+            added++;
+        }
+    }
+
+    //if no thread count is given, every hardware thread is used
+    if (numThreads <= 0){
+        numThreads = thread::hardware_concurrency();
+    }
+    invalidateCache();
+    m_root = buildBalanced(nodes.data(), nodes.size(), ((numThreads < 1) ? 1 : numThreads));
+    settleInline();
+    return added;
 }
 
 //insert
-//adds a new drone into the function
-void Show::insert(const Drone& aDrone){
-    //if statement checks to ensure that the ID is within the valid range and that the drone ID does not exist already by calling findDrone
-    if ((aDrone.getID() >= MINID) && (aDrone.getID() <= MAXID) && !(findDrone(aDrone.getID()))){
-        //next if statement checks to ensure the light colors are valid
-        if ((aDrone.getType() == RED) || (aDrone.getType() == BLUE) || (aDrone.getType() == GREEN)){
-            //if statement checks to ensure that the state is valid
-            if ((aDrone.getState() == LIGHTON) || (aDrone.getState() == LIGHTOFF)){
-                //if statement firsts check if m_root is a nullptr, and thus an empty object
-                if (m_root == nullptr){
-                    //m_root is dynamically allocated to be a new object
-                    m_root = new Drone(aDrone.getID(), aDrone.getType(), aDrone.getState());
-                }
-                //else, recursiveInsert is called, and m_root is sent as the starting parameter
-                else{
-                    m_root = recursiveInsert(aDrone, m_root); //recursiveinsert with m_root sent
-                }
+//adds a new drone into the function, reports whether it was inserted, a duplicate, or invalid
+INSERTRESULT Show::insert(const Drone& aDrone){
+    return insert(aDrone.getID(), aDrone.getType(), aDrone.getState());
+}
+
+//insert
+//emplace style insert, makes a single descent and rebalances on the way back up
+INSERTRESULT Show::insert(int id, LIGHTCOLOR type, STATE state){
+    //if statement checks to ensure that the ID, light color, and state are all valid
+    if (!isValid(id, type, state)){
+        return INVALID;
+    }
+
+    //if statement checks if the drone goes into the inline array, which is shifted to make room and relinked
+    if (m_inlineMode){
+        int slot = searchInline(id);
+        if ((slot < m_numInline) && (m_inline[slot].getID() == id)){
+            return DUPLICATE;
+        }
+        if (m_numInline < m_promoteAbove){
+            for (int i = m_numInline; i > slot; i--){
+                m_inline[i] = m_inline[i - 1];
+            }
+            m_inline[slot] = Drone(id, type, state);
+            m_numInline++;
+            relinkInline();
+            if (m_indexed){
+                indexDrone(id, type, state);
+            }
+            return INSERTED;
+        }
+        //else, the array is full, so the drones move to the pool and the drone is inserted there
+        promote();
+    }
+
+    //an ID beyond an end whose finger is still valid is appended there without a descent
+    if (fingerValid(RIGHTSIDE) && (id > fingerEnd(RIGHTSIDE)->getID())){
+        return append(RIGHTSIDE, id, type, state);
+    }
+    if (fingerValid(LEFTSIDE) && (id < fingerEnd(LEFTSIDE)->getID())){
+        return append(LEFTSIDE, id, type, state);
+    }
+
+    //path holds every link followed from m_root, so the heights can be fixed without recursion
+    DroneLink* path[MAXDEPTH];
+    int depth = 0;
+    DroneLink* link = &m_root;
+    bool rightmost = true;
+    bool leftmost = true;
+
+    //while loop descends until an empty link is found, which is where the drone belongs
+    while (*link != nullptr){
+        Drone* curr = *link;
+        //if the ID is already in the tree, nothing is changed
+        if (id == curr->getID()){
+            return DUPLICATE;
+        }
+        curr->pushTag();
+        path[depth++] = link;
+        bool goLeft = (id < curr->getID());
+        rightmost = rightmost && !goLeft;
+        leftmost = leftmost && goLeft;
+        link = (goLeft ? &curr->m_left : &curr->m_right);
+    }
+
+    *link = m_pool.allocate(id, type, state);
+    if (m_indexed){
+        indexDrone(id, type, state);
+    }
+    rebalancePath(path, depth);
+    //a drone that landed at an end starts that end's finger, so the next one beyond it needs no descent
+    if (rightmost){
+        walkFinger(RIGHTSIDE, 0);
+    }
+    else if (leftmost){
+        walkFinger(LEFTSIDE, 0);
+    }
+    return INSERTED;
+}
+
+//insert
+//hinted insert, the drone belongs right before hint if its ID falls between hint's and the one before it
+//its spot is then the left link of hint or the right link of the drone before it, both reached from hint's path
+//with end as the hint the right finger is used, and a hint that does not fit falls back to a normal insert
+INSERTRESULT Show::insert(const_iterator hint, const Drone& aDrone){
+    int id = aDrone.getID();
+    if (!isValid(id, aDrone.getType(), aDrone.getState()) || m_inlineMode || (m_root == nullptr) || (hint.m_root != m_root)){
+        return insert(aDrone);
+    }
+    //if statement checks if hint is end, where the drone must be above the largest ID
+    if (hint.m_depth == 0){
+        if (!fingerValid(RIGHTSIDE)){
+            walkFinger(RIGHTSIDE, 0);
+        }
+        return ((id > fingerEnd(RIGHTSIDE)->getID()) ? append(RIGHTSIDE, id, aDrone.getType(), aDrone.getState()) : insert(aDrone));
+    }
+    if (id >= hint->getID()){
+        return insert(aDrone);
+    }
+
+    //for loop turns hint's path into the links followed from m_root, ending at hint's left link
+    DroneLink* path[MAXDEPTH];
+    int depth = 0;
+    DroneLink* link = &m_root;
+    for (int i = 0; i < hint.m_depth; i++){
+        Drone* curr = *link;
+        curr->pushTag();
+        path[depth++] = link;
+        link = (((i + 1 == hint.m_depth) || (curr->m_left == hint.m_path[i + 1])) ? &curr->m_left : &curr->m_right);
+    }
+    //the drone before hint is the rightmost of hint's left subtree, or else the last drone the path turned right at
+    const Drone* before = nullptr;
+    if (*link != nullptr){
+        while (*link != nullptr){
+            (*link)->pushTag();
+            path[depth++] = link;
+            link = &(*link)->m_right;
+        }
+        before = *path[depth - 1];
+    }
+    else{
+        for (int i = hint.m_depth - 2; (i >= 0) && (before == nullptr); i--){
+            if (hint.m_path[i]->getRight() == hint.m_path[i + 1]){
+                before = hint.m_path[i];
             }
         }
     }
+    if ((before != nullptr) && (id <= before->getID())){
+        return insert(aDrone);
+    }
+
+    *link = m_pool.allocate(id, aDrone.getType(), aDrone.getState());
+    if (m_indexed){
+        indexDrone(id, aDrone.getType(), aDrone.getState());
+    }
+    rebalancePath(path, depth);
+    return INSERTED;
+}
+
+//append
+//links a drone beyond one end of the tree through that end's finger, with no descent and no ID comparisons
+//rebalancing only reshapes the spine below the highest link it changed, so the finger is walked again from there
+INSERTRESULT Show::append(SIDE side, int id, LIGHTCOLOR type, STATE state){
+    Finger& finger = m_fingers[side];
+    Drone* spine[MAXDEPTH];
+    for (int i = 0; i < finger.depth; i++){
+        spine[i] = *finger.path[i];
+    }
+    Drone* last = spine[finger.depth - 1];
+    Drone* added = m_pool.allocate(id, type, state);
+    ((side == RIGHTSIDE) ? last->m_right : last->m_left) = added;
+    if (m_indexed){
+        indexDrone(id, type, state);
+    }
+    //above the point where rebalancing settles, each drone's subtree just gained the new drone
+    if (m_burst){
+        rebalancePath(finger.path, finger.depth);
+    }
+    else{
+        for (int i = settlePath(finger.path, finger.depth); i >= 0; i--){
+            (*finger.path[i])->addCounts(added);
+        }
+    }
+    int kept = 0;
+    while ((kept < finger.depth) && (*finger.path[kept] == spine[kept])){
+        kept++;
+    }
+    walkFinger(side, kept);
+    return INSERTED;
+}
+
+//walkFinger
+//keeps the first depth links of the finger and follows the side's links from there down to the end drone
+void Show::walkFinger(SIDE side, int depth){
+    Finger& finger = m_fingers[side];
+    DroneLink* link = &m_root;
+    if (depth > 0){
+        Drone* curr = *finger.path[depth - 1];
+        link = ((side == RIGHTSIDE) ? &curr->m_right : &curr->m_left);
+    }
+    while (*link != nullptr){
+        (*link)->pushTag();
+        finger.path[depth++] = link;
+        link = ((side == RIGHTSIDE) ? &(*link)->m_right : &(*link)->m_left);
+    }
+    finger.depth = depth;
+    finger.epoch = m_cacheEpoch;
 }
 
 //clear
-//deletes the entire tree
+//deletes the entire tree, every slab is released at once instead of walking the tree
+//the indexes are emptied but stay enabled
 void Show::clear(){
-    recursiveClear(m_root);
+    m_pool.releaseAll();
     m_root = nullptr;
+    m_inlineMode = (m_promoteAbove > 0);
+    m_numInline = 0;
+    m_compactCursor = NOT_COMPACTING;
+    m_hits.assign(m_hits.size(), 0);
+    invalidateCache();
+    for (int i = 0; i < NUMCOLORS; i++){
+        m_colorIndex[i].clear();
+    }
+    for (int i = 0; i < NUMSTATES; i++){
+        m_stateIndex[i].clear();
+    }
 }
 
 //remove
-//removes a drone from a tree
-void Show::remove(int id){
-    //if statement checks to ensure the id is within the tree
-    if (findDrone(id)){
-        m_root = recursiveRemove(id, m_root); 
+//removes a drone from a tree with a single descent, reports whether it was removed or absent
+REMOVERESULT Show::remove(int id){
+    //if statement checks if the drone is in the inline array, which is shifted over it and relinked
+    if (m_inlineMode){
+        int slot = searchInline(id);
+        if ((slot == m_numInline) || (m_inline[slot].getID() != id)){
+            return ABSENT;
+        }
+        if (m_indexed){
+            unindexDrone(id, m_inline[slot].getType(), m_inline[slot].getState());
+        }
+        for (int i = slot + 1; i < m_numInline; i++){
+            m_inline[i - 1] = m_inline[i];
+        }
+        m_numInline--;
+        relinkInline();
+        return REMOVED;
     }
+
+    DroneLink* path[MAXDEPTH];
+    int depth = 0;
+    DroneLink* link = &m_root;
+
+    //while loop descends until the drone is found or the tree runs out
+    while ((*link != nullptr) && ((*link)->getID() != id)){
+        (*link)->pushTag();
+        path[depth++] = link;
+        link = ((id < (*link)->getID()) ? &(*link)->m_left : &(*link)->m_right);
+    }
+
+    //if link is empty then the ID was never in the tree
+    if (*link == nullptr){
+        return ABSENT;
+    }
+
+    Drone* target = *link;
+    target->pushTag();
+    if (m_indexed){
+        unindexDrone(id, target->getType(), target->getState());
+    }
+    //if statement checks if target has two children, in which case the inorder successor takes its place
+    if ((target->m_left != nullptr) && (target->m_right != nullptr)){
+        path[depth++] = link;
+        DroneLink* successorLink = &target->m_right;
+
+        //while loop goes through and finds the furthest left node from right as the successor
+        while ((*successorLink)->m_left != nullptr){
+            (*successorLink)->pushTag();
+            path[depth++] = successorLink;
+            successorLink = &(*successorLink)->m_left;
+        }
+
+        //the successor's data is moved into target, and the successor's node is unlinked instead
+        Drone* successor = *successorLink;
+        successor->pushTag();
+        target->setID(successor->getID());
+        target->setType(successor->getType());
+        target->setState(successor->getState());
+        *successorLink = successor->m_right;
+        m_pool.release(successor);
+    }
+    //else, target has at most one child which simply slides up
+    else{
+        *link = ((target->m_left != nullptr) ? target->m_left : target->m_right);
+        m_pool.release(target);
+    }
+
+    rebalancePath(path, depth);
+    settleInline();
+    return REMOVED;
 }
 
 //dumpTree and dump
@@ -71,7 +410,7 @@ void Show::dump(Drone* aDrone) const{
     if (aDrone != nullptr){
         cout << "(";
         dump(aDrone->m_left);//first visit the left child
-        cout << aDrone->m_id << ":" << aDrone->m_height;//second visit the node itself
+        cout << aDrone->getID() << ":" << aDrone->getHeight();//second visit the node itself
         dump(aDrone->m_right);//third visit the right child
         cout << ")";
     }
@@ -85,19 +424,32 @@ void Show::listDrones() const {
         cout << "Empty tree" << endl;
     }
     else{
-        //else, inorderList is called to list all drones within the tree
-        inorderList(m_root);
+        //else, every drone is listed in order through the iterators
+        //getStateStr and getTypeStr used since it displays the data associated with the enum
+        for (const Drone& curr : *this){
+            cout << curr.getID() << ":" << curr.getStateStr() << ":" << curr.getTypeStr() << endl;
+        }
     }
 }
 
 //setState
-//finds the ID, and changes the state
+//finds the ID, and changes the state, the counters of every drone on the way down are moved to the new state
 bool Show::setState(int id, STATE state){
-    //if statement checks to ensure that the state is valid
-    if ((state == LIGHTON) || (state == LIGHTOFF)){
+    //if statement checks to ensure that the ID and state are valid, an ID out of range can never be in the show
+    if (((id >= MINID) && (id <= MAXID)) && ((state == LIGHTON) || (state == LIGHTOFF))){
+        //with the hot cache on, the path comes from the cache, so a recently used drone needs no descent
+        if (!m_hotCache.empty()){
+            int depth;
+            Drone* const* path = probe(id, depth);
+            return ((path != nullptr) && changeState(path, depth, state));
+        }
+        Drone* path[MAXDEPTH];
+        int depth = 0;
         Drone* curr = m_root;
         //while loop goes until curr equals nullptr, meaning the ID isn't in the list
         while (curr != nullptr){
+            curr->pushTag();
+            path[depth++] = curr;
             //if id is less than the current ID, goes to left
             if (id < curr->getID()){
                 curr = curr->getLeft();
@@ -108,15 +460,7 @@ bool Show::setState(int id, STATE state){
             }
             //else, id is equal to curr->getID(), meaning that the state will be changed
             else{
-                //if statement checks to ensure that the states are different, or else nothing is changed and false returned
-                if (state != curr->getState()){
-                    curr->setState(state);
-                    return true;
-                }
-                else{
-                    return false;
-                }
-
+                return changeState(path, depth, state);
             }
         }
     }
@@ -124,11 +468,20 @@ bool Show::setState(int id, STATE state){
 }
 
 //removeLightOff
-//removes any drones with their lights off
+//removes any drones with their lights off, in one linear pass through removeIf
+//if the state index shows only a few are off, they are removed one at a time in O(k log n) instead
 void Show::removeLightOff(){
-    //ensures m_root is not a nullptr
-    if (m_root != nullptr){
-        m_root = lightsOff(m_root); //lightsOff called with m_root
+    int numOff = countDrones(LIGHTOFF);
+    if (m_indexed && (numOff * FEW_REMOVALS < countDrones())){
+        vector<int> ids;
+        ids.reserve(numOff);
+        m_stateIndex[LIGHTOFF].forEach([&](int id){ids.push_back(id);});
+        for (unsigned int i = 0; i < ids.size(); i++){
+            remove(ids[i]);
+        }
+    }
+    else{
+        removeIf([](const Drone& aDrone){return aDrone.getState() == LIGHTOFF;});
     }
 }
 
@@ -139,6 +492,15 @@ bool Show::findDrone(int id) const {
     if ((id < MINID) || (id > MAXID) || (m_root == nullptr)){
         return false;
     }
+    //with the hot cache on, a recently used drone is found with one probe
+    else if (!m_hotCache.empty()){
+        int depth;
+        bool found = (probe(id, depth) != nullptr);
+        if (found && (m_balance == ADAPTIVE)){
+            const_cast<Show*>(this)->adapt(id);
+        }
+        return found;
+    }
     //else, recursiveFind is used
     else{
         Drone* curr = m_root;
@@ -154,6 +516,10 @@ bool Show::findDrone(int id) const {
             }
             //else, id is equal to curr->getID(), meaning that the ID is in the list
             else{
+                //an adaptive show reshapes itself on lookups, which callers are told findDrone does
+                if (m_balance == ADAPTIVE){
+                    const_cast<Show*>(this)->adapt(id);
+                }
                 return true;
             }
         }
@@ -161,374 +527,1141 @@ bool Show::findDrone(int id) const {
     }
 }
 
-//operator=
-//assigns an rhs to another, avoids self assignment
-const Show & Show::operator=(const Show & rhs){
-    if (this != &rhs){
-        clear(); //this is cleared
+//rank
+//counts the drones with smaller IDs, every time the descent goes right the left subtree and the drone itself are passed
+int Show::rank(int id) const{
+    settleCounters();
+    int position = 0;
+    Drone* curr = m_root;
+    while (curr != nullptr){
+        if (curr->getID() < id){
+            position += 1 + ((curr->getLeft() == nullptr) ? 0 : curr->getLeft()->getSize());
+            curr = curr->getRight();
+        }
+        else{
+            curr = curr->getLeft();
+        }
+    }
+    return position;
+}
 
-        //if statement checks to see if m_root is a nullptr, and if so leaves this empty
-        if (rhs.m_root == nullptr){
-            return *this;
+//select
+//finds the drone at position k by comparing k with the size of each left subtree on the way down
+const Drone* Show::select(int k) const{
+    settleCounters();
+    if ((k < 0) || (k >= countDrones())){
+        return nullptr;
+    }
+    Drone* curr = m_root;
+    while (curr != nullptr){
+        reveal(curr);
+        int leftSize = ((curr->getLeft() == nullptr) ? 0 : curr->getLeft()->getSize());
+        if (k < leftSize){
+            curr = curr->getLeft();
+        }
+        else if (k > leftSize){
+            k -= leftSize + 1;
+            curr = curr->getRight();
         }
-        //else, preOrderAssignment called with rhsDrone's m_root
         else{
-            m_root = preOrderAssignment(rhs.m_root);
+            return curr;
         }
     }
-    return *this;
+    return nullptr;
 }
 
-//countDrones
-//counts the number of drones of a certain color 
-int Show::countDrones(LIGHTCOLOR aColor) const{
-    //if m_root is equal to nullptr, means that no drones exist of that color due to the list being empty
-    if (m_root == nullptr){
+//listDrones
+//copies one page of drones into buffer, costing O(log n + limit) instead of a full traversal
+int Show::listDrones(int offset, int limit, Drone buffer[]) const{
+    settleCounters();
+    if ((offset < 0) || (limit <= 0)){
         return 0;
     }
-    else{
-        return postOrderCount(aColor, m_root);
+    //stack holds the drones still to be listed whose right subtrees have not been visited
+    const Drone* stack[MAXDEPTH];
+    int depth = 0;
+    const Drone* curr = m_root;
+
+    //while loop descends to position offset, stacking each drone the page will pass on the way back up
+    while (curr != nullptr){
+        reveal(curr);
+        int leftSize = ((curr->getLeft() == nullptr) ? 0 : curr->getLeft()->getSize());
+        if (offset <= leftSize){
+            stack[depth++] = curr;
+            if (offset == leftSize){
+                break;
+            }
+            curr = curr->getLeft();
+        }
+        else{
+            offset -= leftSize + 1;
+            curr = curr->getRight();
+        }
+    }
+
+    //while loop lists in order from the stack until the page is full
+    int numListed = 0;
+    while ((depth > 0) && (numListed < limit)){
+        curr = stack[--depth];
+        buffer[numListed++] = Drone(curr->getID(), curr->getType(), curr->getState());
+        //the right subtree comes next, so its leftmost path is stacked
+        for (curr = curr->getRight(); curr != nullptr; curr = curr->getLeft()){
+            reveal(curr);
+            stack[depth++] = curr;
+        }
     }
+    return numListed;
 }
 
-//recursiveInsert
-//Helper function which exists to insert the drone recursively
-Drone* Show::recursiveInsert(const Drone& aDrone, Drone* curr){
-   //if statement checks to see if curr is a nullptr, and if so newDrone is returned
-   //this is the base case of the recursive function
-   if (curr == nullptr){
-        //newDrone declared and initialized
-        Drone* newDrone = new Drone(aDrone.getID(), aDrone.getType(), aDrone.getState());
-        return newDrone; //newDrone returned
+//sampleDrone
+//picks a position uniformly at random and selects it, costing O(log n)
+const Drone* Show::sampleDrone(mt19937& generator) const{
+    settleCounters();
+    if (m_root == nullptr){
+        return nullptr;
     }
-    //else if aDrone's Id is less than curr's ID, yet it doesn't exist, it recurses to the left
-    else if ((aDrone.getID() < curr->getID())){
-        curr->setLeft(recursiveInsert(aDrone, curr->getLeft())); //goes to the left by calling getLeft of curr
+    uniform_int_distribution<int> positions(0, m_root->getSize() - 1);
+    return select(positions(generator));
+}
+
+//floor
+//keeps the last drone passed whose ID was not above id
+const Drone* Show::floor(int id) const{
+    const Drone* best = nullptr;
+    const Drone* curr = m_root;
+    while (curr != nullptr){
+        reveal(curr);
+        if (curr->getID() <= id){
+            best = curr;
+            curr = curr->getRight();
+        }
+        else{
+            curr = curr->getLeft();
+        }
     }
-    //else, if the aDrone's ID is greater than curr's ID, then it recurses to the right
-    else{
-        curr->setRight(recursiveInsert(aDrone, curr->getRight())); //goes to the right by calling getRight of curr
+    return best;
+}
+
+//ceiling
+//keeps the last drone passed whose ID was not below id
+const Drone* Show::ceiling(int id) const{
+    const Drone* best = nullptr;
+    const Drone* curr = m_root;
+    while (curr != nullptr){
+        reveal(curr);
+        if (curr->getID() >= id){
+            best = curr;
+            curr = curr->getLeft();
+        }
+        else{
+            curr = curr->getRight();
+        }
     }
+    return best;
+}
 
-    //height for curr is updated, since it found it's place and needs to be set to zero
-    updateHeight(curr);
+//successor
+//the ceiling of the next ID up, bounded so it cannot overflow
+const Drone* Show::successor(int id) const{
+    return ((id >= MAXID) ? nullptr : ceiling(id + 1));
+}
 
-    //int height difference initialized to checkBalance to see what the difference is
-    int heightDifference = checkBalance(curr);
+//predecessor
+//the floor of the next ID down, bounded so it cannot overflow
+const Drone* Show::predecessor(int id) const{
+    return ((id <= MINID) ? nullptr : floor(id - 1));
+}
 
-    //if the height difference is greater than 1 or less than -1, that means that it is imbalanced
-    //it returns the trinode restructure of curr to the recursive function
-    if ((heightDifference < -1) || (heightDifference > 1)){
-        return trinodeRestructure(curr);
+//removeRange
+//splits off the block of IDs [loId, hiId], releases it, and joins the two outer trees back together
+//the splits and the join cost O(log n), plus O(k) to hand the k removed drones back to the pool
+int Show::removeRange(int loId, int hiId){
+    if ((m_root == nullptr) || (loId > hiId)){
+        return 0;
+    }
+    //hiId is bounded first so hiId + 1 cannot overflow
+    if (hiId > MAXID){
+        hiId = MAXID;
     }
-    
-    return curr; //curr is returned if no rebalancing is needed
+    if (m_inlineMode){
+        promote();
+    }
+    settleBurst();
+    Drone* below;
+    Drone* rest;
+    Drone* inRange;
+    Drone* above;
+    split(m_root, loId, below, rest);
+    split(rest, hiId + 1, inRange, above);
+
+    int numRemoved = ((inRange == nullptr) ? 0 : inRange->getSize());
+    releaseSubtree(inRange);
+    m_root = joinTrees(below, above);
+    settleInline();
+    return numRemoved;
 }
 
-//recursiveClear
-//uses recursion to completely delete the tree, using postorder traversal
-void Show::recursiveClear(Drone* aDrone){
-    //if statement checks to ensure that aDrone is not a nullptr
-    if (aDrone != nullptr){
-        //postorder traversal used to completely delete the tree
-        recursiveClear(aDrone->getLeft());
-        recursiveClear(aDrone->getRight());
-        delete aDrone;
+//setStateRange
+//every state maps to state, so the tag turns the other state into it
+void Show::setStateRange(int loId, int hiId, STATE state){
+    if ((state != LIGHTON) && (state != LIGHTOFF)){
+        return;
     }
+    int types[NUMCOLORS] = {RED, GREEN, BLUE};
+    int states[NUMSTATES] = {state, state};
+    retag(loId, hiId, Drone::makeTag(types, states));
 }
 
-//recursiveRemove
-//finds a drone within a system then deletes it
-Drone* Show::recursiveRemove(int id, Drone* curr){
-    //if statement checks to see if the ID is greater, less than, or equal to the curr drone
-    //Not checked if equal since checked in remove whether or not it is found using find()
-    if (id > curr->getID()){
-        curr->setRight(recursiveRemove(id, curr->getRight()));
-    }
-    else if (id < curr->getID()){
-        curr->setLeft(recursiveRemove(id, curr->getLeft()));
+//setTypeRange
+//every color maps to type, so the tag turns the other two colors into it
+void Show::setTypeRange(int loId, int hiId, LIGHTCOLOR type){
+    if ((type < RED) || (type > BLUE)){
+        return;
     }
-    //else statement is when id == curr->getID(), since we know it exists in the tree since find() was used
-    else{
-        //if statement checks if everything is nullptr
-        if ((curr->getLeft() == nullptr) && (curr->getRight() == nullptr)){
-            delete curr;
-            return nullptr; //nullptr simply returned
-        }
-        //else statement checks if curr->getLeft is nullptr but getRight isn't
-        else if ((curr->getLeft() == nullptr) && (curr->getRight() != nullptr)){
-            Drone* temp = curr->getRight(); //temp ptr holds onto curr->getRight
-            delete curr;
-            return temp; //temp, or curr's right node returned since height will always be zero due to rebalancing
-        }
-        //else statement checks if curr->getLeft() isn't nullptr but getRight is
-        else if ((curr->getLeft() != nullptr) && (curr->getRight() == nullptr)){
-            Drone* temp = curr->getLeft(); //temp ptr holds onto curr->getleft()
-            delete curr; //curr deleted
-            return temp; //temp returned
-        }
-        //else is for both left and right not being nullptrs
-        else{
-            //drone pointers tempLeft and tempRight declared
-            Drone* tempLeft;
-            Drone* tempRight;
+    int types[NUMCOLORS] = {type, type, type};
+    int states[NUMSTATES] = {LIGHTON, LIGHTOFF};
+    retag(loId, hiId, Drone::makeTag(types, states));
+}
 
-            Drone* replacement = curr->getRight(); //replacement is the node which replaces curr
+//recolor
+//the whole tree is in range, so the tag lands on the root alone
+void Show::recolor(LIGHTCOLOR from, LIGHTCOLOR to){
+    if ((from < RED) || (from > BLUE) || (to < RED) || (to > BLUE)){
+        return;
+    }
+    int types[NUMCOLORS] = {RED, GREEN, BLUE};
+    int states[NUMSTATES] = {LIGHTON, LIGHTOFF};
+    types[from] = to;
+    retag(MINID, MAXID, Drone::makeTag(types, states));
+}
 
-            //while loop goes through and finds the furthest left node from right as the successor
-            while (replacement->getLeft() != nullptr){
-                replacement = replacement->getLeft();
+//retag
+//the range is bounded to the valid IDs, then the indexes, the inline array, or the tree are changed
+//every tag made above sends each color and state to one the tag leaves alone, so each bitmap moves straight into its target
+void Show::retag(int loId, int hiId, int tag){
+    loId = ((loId < MINID) ? MINID : loId);
+    hiId = ((hiId > MAXID) ? MAXID : hiId);
+    if ((tag == 0) || (loId > hiId)){
+        return;
+    }
+    if (m_indexed){
+        for (int type = 0; type < NUMCOLORS; type++){
+            if (Drone::tagType(tag, type) != type){
+                m_colorIndex[type].moveRange(m_colorIndex[Drone::tagType(tag, type)], loId, hiId);
+            }
+        }
+        for (int state = 0; state < NUMSTATES; state++){
+            if (Drone::tagState(tag, state) != state){
+                m_stateIndex[state].moveRange(m_stateIndex[Drone::tagState(tag, state)], loId, hiId);
             }
+        }
+    }
+    //if statement checks if the drones are inline, where there are too few to be worth tagging
+    if (m_inlineMode){
+        for (int i = 0; i < m_numInline; i++){
+            if ((m_inline[i].getID() >= loId) && (m_inline[i].getID() <= hiId)){
+                m_inline[i].setType(static_cast<LIGHTCOLOR>(Drone::tagType(tag, m_inline[i].getType())));
+                m_inline[i].setState(static_cast<STATE>(Drone::tagState(tag, m_inline[i].getState())));
+            }
+        }
+        relinkInline();
+        return;
+    }
+    //the cached paths and fingers assume nothing above them holds a tag
+    invalidateCache();
+    applyRange(m_root, loId, hiId, tag, MINID, MAXID);
+}
 
+//applyRange
+//a subtree whose IDs all lie in range takes the tag whole, one partly in range splits it between its drone and its children
+//only the drones on the paths to loId and hiId are partly in range, so like a range count this costs O(log n)
+//during a burst a marked drone's counters are recomputed from stale ones, which is fine since settling recomputes them
+void Show::applyRange(Drone* curr, int loId, int hiId, int tag, int subLo, int subHi){
+    if ((curr == nullptr) || (subHi < loId) || (subLo > hiId)){
+        return;
+    }
+    if ((loId <= subLo) && (subHi <= hiId)){
+        curr->applyTag(tag);
+        return;
+    }
+    curr->pushTag();
+    int id = curr->getID();
+    if ((id >= loId) && (id <= hiId)){
+        curr->setType(static_cast<LIGHTCOLOR>(Drone::tagType(tag, curr->getType())));
+        curr->setState(static_cast<STATE>(Drone::tagState(tag, curr->getState())));
+    }
+    applyRange(curr->getLeft(), loId, hiId, tag, subLo, id - 1);
+    applyRange(curr->getRight(), loId, hiId, tag, id + 1, subHi);
+    updateCounts(curr);
+}
+
+//begin
+//the path down the left spine leads to the smallest ID
+Show::const_iterator Show::begin() const{
+    const_iterator first(m_root);
+    first.pushLeftmost(m_root);
+    return first;
+}
+
+//end
+//an empty path marks one past the largest ID
+Show::const_iterator Show::end() const{
+    return const_iterator(m_root);
+}
+
+//lower_bound
+//descends toward id, then cuts the path back to the last drone whose ID was not below id
+Show::const_iterator Show::lower_bound(int id) const{
+    const_iterator bound(m_root);
+    int boundDepth = 0;
+    const Drone* curr = m_root;
+    while (curr != nullptr){
+        reveal(curr);
+        bound.m_path[bound.m_depth++] = curr;
+        if (curr->getID() >= id){
+            boundDepth = bound.m_depth;
+            curr = curr->getLeft();
+        }
+        else{
+            curr = curr->getRight();
+        }
+    }
+    bound.m_depth = boundDepth;
+    return bound;
+}
 
-            //tempLeft and tempRight initialized to hold the subtrees of curr
-            tempLeft = curr->getLeft();
-            tempRight = curr->getRight();
+//upper_bound
+//the first drone above id is the lower bound of the next ID up
+Show::const_iterator Show::upper_bound(int id) const{
+    return ((id >= MAXID) ? end() : lower_bound(id + 1));
+}
 
-            delete curr; //curr is deleted
+//freeze
+//lists the IDs in order through the iterators and lays them out in a snapshot
+FrozenShow Show::freeze() const{
+    vector<int> sortedIds;
+    sortedIds.reserve(countDrones());
+    for (const Drone& aDrone : *this){
+        sortedIds.push_back(aDrone.getID());
+    }
+    return FrozenShow(sortedIds.data(), sortedIds.size());
+}
 
-            //curr is set to a new Drone, and the left and right subtrees are placed
-            curr = new Drone(replacement->getID(), replacement->getType(), replacement->getState());
-            curr->setLeft(tempLeft); //left subtree is tempLeft since no changes occured
-            
-            //replacement needs to be deleted, so setRight is the right subtree recursed through until replacement is reached and deleted
-            //done recursively to check if any height imbalances occur due to deleting replacement
-            curr->setRight(recursiveRemove(replacement->getID(), tempRight));
+//compact
+//lists the drones in the layout's order, copies them into one new slab in that order, and frees the old slabs
+//after each copy the old drone's right link points at its copy, so the second pass repoints every link in O(n)
+CompactReport Show::compact(LAYOUT layout){
+    CompactReport report;
+    report.scanBefore = scanStride();
+    report.descentBefore = descentPages();
+    //an inline show is already one contiguous array in order
+    if (m_inlineMode){
+        report.scanAfter = report.scanBefore;
+        report.descentAfter = report.descentBefore;
+        return report;
+    }
 
-            replacement = nullptr;
+    vector<Drone*> nodes;
+    nodes.reserve(m_pool.inUse());
+    if (layout == VANEMDEBOAS){
+        settleBurst();
+        vebOrder(m_root, heightOf(m_root) + 1, nodes);
+    }
+    else{
+        flattenInorder(m_root, nodes);
+    }
+
+    invalidateCache();
+    m_pool.beginRelocation(nodes.size());
+    vector<Drone*> moved(nodes.size());
+    for (unsigned int i = 0; i < nodes.size(); i++){
+        moved[i] = m_pool.relocate(nodes[i]);
+        nodes[i]->m_right = moved[i];
+    }
+    //for loop repoints every copied link from the old drone to its copy
+    for (unsigned int i = 0; i < moved.size(); i++){
+        if (moved[i]->m_left != nullptr){
+            moved[i]->m_left = moved[i]->m_left->m_right;
+        }
+        if (moved[i]->m_right != nullptr){
+            moved[i]->m_right = moved[i]->m_right->m_right;
         }
     }
+    if (m_root != nullptr){
+        m_root = m_root->m_right;
+    }
+    m_pool.finishRelocation();
+    m_compactCursor = NOT_COMPACTING;
 
-    //height for curr is updated, since it needs to be deleted from the tree
-    updateHeight(curr);
+    report.scanAfter = scanStride();
+    report.descentAfter = descentPages();
+    return report;
+}
 
-    //int height difference initialized to checkBalance to see what the difference is
-    int heightDifference = checkBalance(curr);
+//compactStep
+//moves the next maxDrones drones in ID order into the new slabs, each found by a descent that keeps the link to it
+//other changes may run between steps, drones they add or move behind the cursor are swept up in the last step
+bool Show::compactStep(int maxDrones){
+    if (m_inlineMode){
+        return true;
+    }
+    if (m_compactCursor == NOT_COMPACTING){
+        m_pool.beginRelocation(m_pool.inUse());
+        m_compactCursor = 0;
+    }
+    invalidateCache();
+    for (int i = 0; i < maxDrones; i++){
+        //while loop finds the link to the drone with the smallest ID above the cursor
+        DroneLink* next = nullptr;
+        DroneLink* link = &m_root;
+        while (*link != nullptr){
+            if ((*link)->getID() > m_compactCursor){
+                next = link;
+                link = &(*link)->m_left;
+            }
+            else{
+                link = &(*link)->m_right;
+            }
+        }
+        //if there is no drone past the cursor, the stragglers are moved and the old slabs freed
+        if (next == nullptr){
+            relocateStragglers(&m_root);
+            m_pool.finishRelocation();
+            m_compactCursor = NOT_COMPACTING;
+            return true;
+        }
+        m_compactCursor = (*next)->getID();
+        //a remove may have moved an ID into a drone that was already relocated, which is left where it is
+        if (!m_pool.isRelocated(*next)){
+            *next = m_pool.relocate(*next);
+        }
+    }
+    return false;
+}
 
-    //if the height difference is greater than 1 or less than -1, that means that it is imbalanced
-    //it returns the trinode restructure of curr to the recursive function
-    if ((heightDifference < -1) || (heightDifference > 1)){
-        return trinodeRestructure(curr);
+//scanStride
+//walks the drones in order, adding up how far apart in memory each is from the one before
+double Show::scanStride() const{
+    int numDrones = countDrones();
+    if (numDrones < 2){
+        return 1;
     }
-    
-    return curr;
+    double total = 0;
+    const Drone* prev = nullptr;
+    for (const Drone& curr : *this){
+        if (prev != nullptr){
+            total += distanceBetween(&curr, prev);
+        }
+        prev = &curr;
+    }
+    return total / (numDrones - 1);
 }
 
-//trinodeRestructure
-//helper function which restructures the tree based on the trinode restructure theorem
-Drone* Show::trinodeRestructure(Drone* zDrone){
-    //drone pointers subtree0, subtree1, subtree2, and subtree3 are declared
-    Drone* subtree0; //subtree0 is the least subtree
-    Drone* subtree1; //subtree1 is the second to least subtree
-    Drone* subtree2; //subtree2 is the second to greatest subtree
-    Drone* subtree3; //subtree3 is the greatest subtree
-    
-    Drone* yDrone = tallestChild(zDrone); //yDrone declared and initialized based on y's place in trinode restructure theorem
-    Drone* xDrone = tallestChild(yDrone); //tallestChild of yDrone is used as the xDrone within the trinode restructure
-    
-    
-    //drones a, b, c are declared. They are initialized below with the if else statements
-    Drone* a;
-    Drone* b;
-    Drone* c;
-
-    //if statement checks to see which drone has the lowest ID
-    //based on inorder traversal, a is assigned to the lowest ID
-    if ((xDrone->getID() < yDrone->getID()) && (xDrone->getID() < zDrone->getID())){
-        a = xDrone;
-    }
-    //else if yDrone is less than everything else, it becomes the a
-    else if ((yDrone->getID() < xDrone->getID()) && (yDrone->getID() < zDrone->getID())){
-        a = yDrone;
-    }
-    //if none of the others are true, zDrone becomes a
-    else{
-        a = zDrone;
+//descentPages
+//adds up, for every drone, how many times the path down to it crosses onto a different page
+double Show::descentPages() const{
+    double total = 0;
+    countPages(m_root, 0, 0, total);
+    return ((m_root == nullptr) ? 0 : total / countDrones());
+}
+
+//apply
+//radix sorts the positions of the ops by ID, SORT_BITS at a time, then merges the batch into the tree in one pass
+//each pass is stable, so the ops on one ID keep the caller's order, and a pass whose bits every ID shares is skipped
+//the sign bit of each ID is flipped so negative IDs sort first
+//done is written through the sorted positions, so it still lines up with ops
+void Show::apply(const DroneOp ops[], int numOps, bool done[]){
+    if (numOps <= 0){
+        return;
+    }
+    vector<int> order(numOps);
+    vector<int> sorted(numOps);
+    for (int i = 0; i < numOps; i++){
+        order[i] = i;
+    }
+    for (int shift = 0; shift < 32; shift += SORT_BITS){
+        vector<int> starts((1 << SORT_BITS) + 1, 0);
+        for (int i = 0; i < numOps; i++){
+            starts[1 + ((((uint32_t)ops[i].id ^ 0x80000000u) >> shift) & ((1 << SORT_BITS) - 1))]++;
+        }
+        if (*max_element(starts.begin(), starts.end()) == numOps){
+            continue;
+        }
+        for (int digit = 0; digit < (1 << SORT_BITS); digit++){
+            starts[digit + 1] += starts[digit];
+        }
+        for (int i = 0; i < numOps; i++){
+            sorted[starts[(((uint32_t)ops[order[i]].id ^ 0x80000000u) >> shift) & ((1 << SORT_BITS) - 1)]++] = order[i];
+        }
+        order.swap(sorted);
+    }
+    vector<int> ids(numOps);
+    for (int i = 0; i < numOps; i++){
+        ids[i] = ops[order[i]].id;
     }
+    //the joins need a pooled tree with real heights
+    if (m_inlineMode){
+        promote();
+    }
+    settleBurst();
+    invalidateCache();
+    m_root = applyBatch(m_root, ops, order.data(), ids.data(), 0, numOps, done);
+    settleInline();
+}
 
-    //second if statement checks to see which is assigned to b
-    //first thing checked is to see what is assigned to a, then lowest ID is checked between the two remaining
-    if (xDrone == a){
-        //if statement checks to see which of the two are lesser
-        if (yDrone->getID() < zDrone->getID()){
-            b = yDrone;
+//applyBatch
+//splits the sorted ops around curr's ID, merges each side into that subtree, then joins the two back around curr
+//a subtree no op reaches is returned untouched, so only the paths the ops share are walked, O(m log(n / m + 1)) for m ops
+Drone* Show::applyBatch(Drone* curr, const DroneOp ops[], const int order[], const int ids[], int first, int last, bool done[]){
+    if (first == last){
+        return curr;
+    }
+    //if statement checks if the ops fell off the tree, where the drones they leave behind are already in order
+    //usually only one ID lands in each empty spot, whose drone is then the whole subtree
+    if (curr == nullptr){
+        if (ids[first] == ids[last - 1]){
+            Drone* added = nullptr;
+            applyGroup(ops, order, first, last, done, added);
+            return added;
         }
-        else{
-            b = zDrone;
+        vector<Drone*> nodes;
+        int start = first;
+        while (start < last){
+            int end = start + 1;
+            while ((end < last) && (ids[end] == ids[start])){
+                end++;
+            }
+            Drone* added = nullptr;
+            applyGroup(ops, order, start, end, done, added);
+            if (added != nullptr){
+                nodes.push_back(added);
+            }
+            start = end;
         }
+        return buildBalanced(nodes.data(), nodes.size(), 1);
+    }
+    curr->pushTag();
+    int id = curr->getID();
+    int below = std::lower_bound(ids + first, ids + last, id) - ids;
+    int above = std::upper_bound(ids + below, ids + last, id) - ids;
+    Drone* left = applyBatch(curr->getLeft(), ops, order, ids, first, below, done);
+    Drone* right = applyBatch(curr->getRight(), ops, order, ids, above, last, done);
+    if (below < above){
+        applyGroup(ops, order, below, above, done, curr);
     }
-    //else if rules out yDrone if yDrone is equal to a
-    else if (yDrone == a){
-        //if statement checks to see which of the two are lesser, and assigns b based on that
-        if (xDrone->getID() < zDrone->getID()){
-            b = xDrone;
+    return ((curr == nullptr) ? joinTrees(left, right) : join(left, curr, right));
+}
+
+//applyGroup
+//runs one ID's ops in order on whether it is present and its color and state, aDrone is nullptr while it is absent
+//the drone is then allocated, changed, or released once, and the indexes follow
+void Show::applyGroup(const DroneOp ops[], const int order[], int first, int last, bool done[], Drone*& aDrone){
+    int id = ops[order[first]].id;
+    bool present = (aDrone != nullptr);
+    LIGHTCOLOR type = (present ? aDrone->getType() : DEFAULT_LIGHT);
+    STATE state = (present ? aDrone->getState() : DEFAULT_STATE);
+    for (int i = first; i < last; i++){
+        const DroneOp& op = ops[order[i]];
+        bool& result = done[order[i]];
+        if (op.kind == INSERTOP){
+            result = !present && isValid(id, op.type, op.state);
+            if (result){
+                present = true;
+                type = op.type;
+                state = op.state;
+            }
+        }
+        else if (op.kind == REMOVEOP){
+            result = present;
+            present = false;
         }
         else{
-            b = zDrone;
+            result = (op.kind == SETSTATEOP) && present && ((op.state == LIGHTON) || (op.state == LIGHTOFF)) && (op.state != state);
+            if (result){
+                state = op.state;
+            }
+        }
+    }
+    if (m_indexed && (aDrone != nullptr)){
+        unindexDrone(id, aDrone->getType(), aDrone->getState());
+    }
+    if (m_indexed && present){
+        indexDrone(id, type, state);
+    }
+    if (!present){
+        if (aDrone != nullptr){
+            m_pool.release(aDrone);
+            aDrone = nullptr;
         }
     }
-    //else is used when zDrone is equal to a
+    else if (aDrone == nullptr){
+        aDrone = m_pool.allocate(id, type, state);
+    }
     else{
-        //if statement checks if a or b are lesser and assigns based on that
-        if (xDrone->getID() < yDrone->getID()){
-            b = xDrone;
+        aDrone->setType(type);
+        aDrone->setState(state);
+    }
+}
+
+//findDrones
+//runs BATCH_LANES descents in lockstep, each step prefetches the child every lane will read next
+//a lane which finishes early simply sits out the remaining steps
+void Show::findDrones(const int ids[], int numIds, bool found[]) const{
+    for (int start = 0; start < numIds; start += BATCH_LANES){
+        int numLanes = ((numIds - start < BATCH_LANES) ? numIds - start : BATCH_LANES);
+        const Drone* curr[BATCH_LANES];
+        int numActive = 0;
+        for (int lane = 0; lane < numLanes; lane++){
+            int id = ids[start + lane];
+            found[start + lane] = false;
+            curr[lane] = (((id < MINID) || (id > MAXID)) ? nullptr : static_cast<Drone*>(m_root));
+            numActive += (curr[lane] != nullptr);
+        }
+        //while loop takes one step down in every lane still searching
+        while (numActive > 0){
+            for (int lane = 0; lane < numLanes; lane++){
+                if (curr[lane] == nullptr){
+                    continue;
+                }
+                int id = ids[start + lane];
+                int currID = curr[lane]->getID();
+                if (id == currID){
+                    found[start + lane] = true;
+                    curr[lane] = nullptr;
+                }
+                else{
+                    curr[lane] = ((id < currID) ? curr[lane]->getLeft() : curr[lane]->getRight());
+                    __builtin_prefetch(curr[lane]);
+                }
+                numActive -= (curr[lane] == nullptr);
+            }
+        }
+    }
+}
+
+//setStates
+//finds every drone in a group of lanes in lockstep like findDrones, keeping each lane's path for the counters
+//the changes are then applied in the order given, so repeated IDs behave the same as calling setState in a loop
+void Show::setStates(const pair<int, STATE> updates[], int numUpdates, bool changed[]){
+    for (int start = 0; start < numUpdates; start += BATCH_LANES){
+        int numLanes = ((numUpdates - start < BATCH_LANES) ? numUpdates - start : BATCH_LANES);
+        Drone* path[BATCH_LANES][MAXDEPTH];
+        int depth[BATCH_LANES];
+        Drone* curr[BATCH_LANES];
+        Drone* target[BATCH_LANES];
+        int numActive = 0;
+        for (int lane = 0; lane < numLanes; lane++){
+            STATE state = updates[start + lane].second;
+            depth[lane] = 0;
+            target[lane] = nullptr;
+            curr[lane] = (((state == LIGHTON) || (state == LIGHTOFF)) ? static_cast<Drone*>(m_root) : nullptr);
+            numActive += (curr[lane] != nullptr);
+        }
+        while (numActive > 0){
+            for (int lane = 0; lane < numLanes; lane++){
+                if (curr[lane] == nullptr){
+                    continue;
+                }
+                int id = updates[start + lane].first;
+                int currID = curr[lane]->getID();
+                curr[lane]->pushTag();
+                path[lane][depth[lane]++] = curr[lane];
+                if (id == currID){
+                    target[lane] = curr[lane];
+                    curr[lane] = nullptr;
+                }
+                else{
+                    curr[lane] = ((id < currID) ? curr[lane]->getLeft() : curr[lane]->getRight());
+                    __builtin_prefetch(curr[lane]);
+                }
+                numActive -= (curr[lane] == nullptr);
+            }
+        }
+        //changing a state never moves a drone, so every path found above is still valid here
+        for (int lane = 0; lane < numLanes; lane++){
+            STATE state = updates[start + lane].second;
+            Drone* found = target[lane];
+            changed[start + lane] = ((found != nullptr) && (found->getState() != state));
+            if (changed[start + lane]){
+                for (int i = 0; i < depth[lane]; i++){
+                    path[lane][i]->moveCount(found->getType(), found->getState(), state);
+                }
+                if (m_indexed){
+                    m_stateIndex[found->getState()].remove(found->getID());
+                    m_stateIndex[state].add(found->getID());
+                }
+                found->setState(state);
+            }
+        }
+    }
+}
+
+//operator=
+//assigns an rhs to another, avoids self assignment
+const Show & Show::operator=(const Show & rhs){
+    if (this != &rhs){
+        clear(); //this is cleared
+
+        //if statement checks to see if m_root is a nullptr, and if so leaves this empty
+        if (rhs.m_root == nullptr){
+            return *this;
         }
+        //else if the copy fits inline, rhs's drones are copied into the array in order
+        else if (m_inlineMode && (rhs.countDrones() <= m_promoteAbove)){
+            for (const Drone& curr : rhs){
+                m_inline[m_numInline++] = Drone(curr.getID(), curr.getType(), curr.getState());
+            }
+            relinkInline();
+            if (m_indexed){
+                rebuildIndexes();
+            }
+        }
+        //else, preOrderAssignment called with rhsDrone's m_root
         else{
-            b = yDrone;
+            //the copy is built from pool drones, so this leaves inline mode first
+            m_inlineMode = false;
+            m_root = preOrderAssignment(rhs.m_root);
+            //this keeps its own balancing too, and only a copied AVL tree suits every policy
+            if ((m_balance != rhs.m_balance) && (rhs.m_balance != AVL)){
+                relinkBalanced();
+            }
+            //a tree copied mid burst carries its marks, which this settles unless it is bursting too
+            if (!m_burst){
+                settleBurst();
+            }
+            //this keeps its own choice of indexes, so they are rebuilt for the new drones
+            if (m_indexed){
+                rebuildIndexes();
+            }
+            settleInline();
         }
     }
+    return *this;
+}
 
-    //if statement checks which c should be initialized to
-    if (((zDrone == a) && (yDrone == b)) || ((yDrone == a) && (zDrone == b))){
-        c = xDrone; //c is xDrone if zDrone is a or yDrone is b or vise versa
+//countDrones
+//counts every drone in the tree, read straight from the root's size
+int Show::countDrones() const{
+    settleCounters();
+    return ((m_root == nullptr) ? 0 : m_root->getSize());
+}
+
+//countDrones
+//counts the number of drones of a certain color, read straight from the root's counters
+int Show::countDrones(LIGHTCOLOR aColor) const{
+    settleCounters();
+    //if m_root is equal to nullptr, means that no drones exist of that color due to the list being empty
+    //the color is checked as well, since it indexes the counters
+    if ((m_root == nullptr) || (aColor < RED) || (aColor > BLUE)){
+        return 0;
     }
-    else if (((zDrone == a) && (xDrone == b)) || ((xDrone == a) && (zDrone == b))){
-        c = yDrone; //c is yDrone if a and b are zDrone and/or xDrone
+    else{
+        return m_root->getCount(aColor, LIGHTON) + m_root->getCount(aColor, LIGHTOFF);
+    }
+}
+
+//countDrones
+//counts the number of drones in a certain state, read straight from the root's counters
+int Show::countDrones(STATE aState) const{
+    settleCounters();
+    if ((m_root == nullptr) || (aState < LIGHTON) || (aState > LIGHTOFF)){
+        return 0;
     }
     else{
-        c = zDrone; //otherwise if yDrone is a or xDrone is b, or vice versa, then zDrone must be c
-    }
-    //if statement checks which variation of the trinode restructure it is
-    //checks if left-left, right-left, right-right, left-right, and makes the subtrees based on that
-    //first statement checks if it is a left-left rotation
-    if ((zDrone == a) && (yDrone == b)){
-        subtree0 = zDrone->getLeft(); //z's left is the least subtree
-        subtree1 = yDrone->getLeft(); //yDrone left is second to least
-        subtree2 = xDrone->getLeft(); //xDrone left is second to greatest
-        subtree3 = xDrone->getRight(); //xDrone right is the greatest
-    }
-    //this checks if it is a right-left rotation
-    else if ((zDrone == a) && (yDrone == c)){
-        subtree0 = zDrone->getLeft(); //z's left is the least subtree
-        subtree1 = xDrone->getLeft(); //xDrone left is the second to least subtree
-        subtree2 = xDrone->getRight(); //xDrone right second to greatest
-        subtree3 = yDrone->getRight(); //yDrone right is the greatest subtree
-    }
-    //else if checks if it is a right-right rotation
-    else if ((zDrone == c) && (yDrone == b)){
-        subtree0 = xDrone->getLeft(); //xDrone left is the least child
-        subtree1 = xDrone->getRight(); //xDrone left is second to least
-        subtree2 = yDrone->getRight(); //yDrone right is second to greatest
-        subtree3 = zDrone->getRight(); //z's right is the greatest subtree
-    }
-    //final else statement is that it is a left-right rotation
+        return m_root->getCount(RED, aState) + m_root->getCount(GREEN, aState) + m_root->getCount(BLUE, aState);
+    }
+}
+
+//countDrones
+//counts the drones of a color and state whose IDs fall within [loId, hiId], using two descents
+int Show::countDrones(LIGHTCOLOR aColor, STATE aState, int loId, int hiId) const{
+    settleCounters();
+    if ((aColor < RED) || (aColor > BLUE) || (aState < LIGHTON) || (aState > LIGHTOFF) || (loId > hiId)){
+        return 0;
+    }
+    //hiId is bounded first so hiId + 1 cannot overflow
+    if (hiId > MAXID){
+        hiId = MAXID;
+    }
+    return countBelow(aColor, aState, hiId + 1) - countBelow(aColor, aState, loId);
+}
+
+//enableIndexes
+//builds a bitmap of IDs for every color and state, which every change keeps up to date from then on
+void Show::enableIndexes(){
+    m_indexed = true;
+    rebuildIndexes();
+}
+
+//disableIndexes
+//drops the bitmaps, changes stop paying to maintain them
+void Show::disableIndexes(){
+    m_indexed = false;
+    for (int i = 0; i < NUMCOLORS; i++){
+        m_colorIndex[i].clear();
+    }
+    for (int i = 0; i < NUMSTATES; i++){
+        m_stateIndex[i].clear();
+    }
+}
+
+//setBalance
+//an AVL tree's heights are valid WAVL ranks and are within the adaptive slack, so switching from AVL costs nothing
+//the other trees may break the new policy's rules, so they are relinked as a perfectly balanced tree
+void Show::setBalance(BALANCE balance){
+    settleBurst();
+    if ((m_balance != AVL) && (balance != m_balance)){
+        relinkBalanced();
+    }
+    m_balance = balance;
+    if (balance == ADAPTIVE){
+        m_hits.assign(MAXID - MINID + 1, 0);
+    }
     else{
-        subtree0 = yDrone->getLeft(); //yDrone left is the least subtree
-        subtree1 = xDrone->getLeft(); //xDrone left is second to least
-        subtree2 = xDrone->getRight(); //xDrone right is second to greatest
-        subtree3 = zDrone->getRight();  //z's right is the greatest subtree
+        vector<unsigned short>().swap(m_hits);
     }
+}
 
-    //b's setLeft is the a drone, and the setRight is c based on trinode theorem
-    b->setLeft(a);
-    b->setRight(c);
+//rotationCount
+//sums the rotations of every policy, which count separately
+long long Show::rotationCount(){
+    return DroneBalance::rotations() + DroneWavl::rotations() + DroneRelaxed::rotations();
+}
 
-    //a's left subtree is set to subtree 0, and a's right subtree is set to subtree1
-    a->setLeft(subtree0);
-    a->setRight(subtree1);
+//relinkBalanced
+//relinks the drones in place as a perfectly balanced tree, whose heights suit every policy
+void Show::relinkBalanced(){
+    vector<Drone*> nodes;
+    nodes.reserve(countDrones());
+    flattenInorder(m_root, nodes);
+    invalidateCache();
+    m_root = buildBalanced(nodes.data(), nodes.size(), 1);
+}
 
-    //c's left subtree is set to subtree3, and c's right subtree is subtree3
-    c->setLeft(subtree2);
-    c->setRight(subtree3);
+//adapt
+//counts an access to id, then rotates its drone above its parent for as long as the parent has fewer accesses
+//and the rotated pair stays within the adaptive slack, so hot drones collect near the root in O(log n) rotations
+//once the climb stops, the ancestors above it are rebalanced in case the subtree's height changed
+void Show::adapt(int id){
+    //a burst leaves the heights the climb checks stale, so lookups during one do not reshape the tree
+    if (m_inlineMode || m_burst){
+        return;
+    }
+    DroneLink* path[MAXDEPTH];
+    int depth = 0;
+    DroneLink* link = &m_root;
+    while ((*link != nullptr) && ((*link)->getID() != id)){
+        (*link)->pushTag();
+        path[depth++] = link;
+        link = ((id < (*link)->getID()) ? &(*link)->m_left : &(*link)->m_right);
+    }
+    if (*link == nullptr){
+        return;
+    }
+    (*link)->pushTag();
+    unsigned short& hits = m_hits[id - MINID];
+    if (++hits == HIT_LIMIT){
+        for (unsigned int i = 0; i < m_hits.size(); i++){
+            m_hits[i] /= 2;
+        }
+    }
 
-    //the heights of a, b, and c are updated
-    updateHeight(a);
-    updateHeight(c);
-    updateHeight(b); //b done last since height of a and c done first
+    int startDepth = depth;
+    while ((depth > 0) && (hits > m_hits[(*path[depth - 1])->getID() - MINID])){
+        Drone* parent = *path[depth - 1];
+        Drone* curr = *link;
+        //the parent moves down, taking curr's inner subtree and keeping its other child
+        bool isLeft = (parent->getLeft() == curr);
+        Drone* outer = (isLeft ? curr->getLeft() : curr->getRight());
+        Drone* inner = (isLeft ? curr->getRight() : curr->getLeft());
+        Drone* sibling = (isLeft ? parent->getRight() : parent->getLeft());
+        int loweredHeight = 1 + max(heightOf(inner), heightOf(sibling));
+        if ((abs(heightOf(inner) - heightOf(sibling)) > DroneRelaxed::slack)
+            || (abs(heightOf(outer) - loweredHeight) > DroneRelaxed::slack)){
+            break;
+        }
+        if (isLeft){
+            parent->setLeft(inner);
+            curr->setRight(parent);
+        }
+        else{
+            parent->setRight(inner);
+            curr->setLeft(parent);
+        }
+        DroneRelaxed::update(parent);
+        DroneRelaxed::update(curr);
+        DroneRelaxed::rotations()++;
+        invalidateCache();
+        *path[depth - 1] = curr;
+        link = path[depth - 1];
+        depth--;
+    }
+    if (depth < startDepth){
+        DroneRelaxed::rebalancePath(path, depth);
+    }
+}
 
-    return b; //b is returned since it replaces zDrone
+//enableHotCache
+//every slot starts empty, and the hit and miss counters start over
+void Show::enableHotCache(int numSlots){
+    int size = 1;
+    while (size < numSlots){
+        size *= 2;
+    }
+    HotEntry empty;
+    empty.id = DEFAULT_ID;
+    empty.depth = 0;
+    empty.epoch = EMPTY_EPOCH;
+    m_hotCache.assign(size, empty);
+    m_cacheHits = 0;
+    m_cacheMisses = 0;
 }
 
-//checkBalance
-//helper function which returns the int to indicate the difference in heights
-int Show::checkBalance(Drone* curr){
-    if (curr->getLeft() == nullptr && curr->getRight() == nullptr){
-        return 0;
+//disableHotCache
+//frees the slots, lookups descend from the root again
+void Show::disableHotCache(){
+    vector<HotEntry>().swap(m_hotCache);
+}
+
+//probe
+//the slot for id holds the path to its drone if it was recorded since the last change that moved or freed a drone
+//otherwise the descent records the path in the slot, so the next lookup of the same drone is one probe
+//returns nullptr if the drone is not in the show
+Drone* const* Show::probe(int id, int& depth) const{
+    HotEntry& entry = m_hotCache[id & (m_hotCache.size() - 1)];
+    if ((entry.id == id) && (entry.epoch == m_cacheEpoch)){
+        m_cacheHits++;
+        depth = entry.depth;
+        return entry.path;
     }
-    else if (curr->getLeft() == nullptr && curr->getRight() != nullptr){
-        return curr->getRight()->getHeight() + 1;
+    m_cacheMisses++;
+    entry.id = DEFAULT_ID;
+    entry.epoch = EMPTY_EPOCH;
+    depth = 0;
+    for (Drone* curr = m_root; curr != nullptr; curr = ((id < curr->getID()) ? curr->getLeft() : curr->getRight())){
+        curr->pushTag();
+        entry.path[depth++] = curr;
+        if (curr->getID() == id){
+            entry.id = id;
+            entry.depth = depth;
+            entry.epoch = m_cacheEpoch;
+            return entry.path;
+        }
     }
-    else if ((curr->getLeft() != nullptr) && (curr->getRight() == nullptr)){
-        return curr->getLeft()->getHeight() + 1;
+    return nullptr;
+}
+
+//changeState
+//every subtree on the path holds its last drone, so one count moves from the old state to the new one in each
+//returns false if the drone is already in that state
+bool Show::changeState(Drone* const path[], int depth, STATE state){
+    Drone* curr = path[depth - 1];
+    bool changed = (state != curr->getState());
+    if (changed){
+        for (int i = 0; i < depth; i++){
+            path[i]->moveCount(curr->getType(), curr->getState(), state);
+        }
+        if (m_indexed){
+            m_stateIndex[curr->getState()].remove(curr->getID());
+            m_stateIndex[state].add(curr->getID());
+        }
+        curr->setState(state);
     }
-    else{
-        return curr->getLeft()->getHeight() - curr->getRight()->getHeight();
+    if (m_balance == ADAPTIVE){
+        adapt(curr->getID());
     }
+    return changed;
+}
+
+//beginBurst
+//from here on inserts and removes skip rebalancing, see relaxPath
+void Show::beginBurst(){
+    m_burst = true;
 }
 
-//tallestChild
-//Compares the height of both of the children, and returns which one has the greater height
-Drone* Show::tallestChild(Drone* parentDrone){
-    //first two cases check if getLeft and getRight are nullptrs returns the opposite
-    //both CANNOT be nullptrs since trinode restructuring would fix issues before getting to that point
-    if (parentDrone->getLeft() == nullptr){
-        return parentDrone->getRight();
+//endBurst
+//settles every subtree the burst changed, then inserts and removes rebalance as they go again
+void Show::endBurst(){
+    settleBurst();
+    m_burst = false;
+}
+
+//relaxPath
+//during a burst a change only marks the drones above it, no heights or counters are touched on the way back up
+//every ancestor of a marked drone is already marked, so marking stops at the first one, O(1) amortized
+//a path longer than log base 3/2 of the size settles the tree early, leaving it no taller than an AVL tree,
+//so every path stays O(log n) and within MAXDEPTH, even when rising IDs grow one long spine
+void Show::relaxPath(DroneLink* path[], int depth){
+    for (int i = depth - 1; (i >= 0) && ((*path[i])->getHeight() != DIRTY_HEIGHT); i--){
+        (*path[i])->setHeight(DIRTY_HEIGHT);
     }
-    else if(parentDrone->getRight() == nullptr){
-        return parentDrone->getLeft();
+    int depthLimit = 0;
+    for (int size = m_pool.inUse(); size > 1; size = size * 2 / 3){
+        depthLimit++;
     }
-    //else statement checks if the left height is less than the right height
-    else if(parentDrone->getLeft()->getHeight() < parentDrone->getRight()->getHeight()){
-        return parentDrone->getRight();
+    if (depth > depthLimit){
+        settleBurst();
     }
-    //else, if the left height is greater than or equal to the left height, then it returns the left height
-    else{
-        return parentDrone->getLeft();
+}
+
+//settleSubtree
+//an unmarked drone roots a subtree the burst left alone, whose heights and counters are still right, so it is skipped
+//each marked drone is joined with its settled children, costing O(difference in their heights), which clears its mark
+Drone* Show::settleSubtree(Drone* curr){
+    if ((curr == nullptr) || (curr->getHeight() != DIRTY_HEIGHT)){
+        return curr;
     }
+    curr->pushTag();
+    Drone* left = settleSubtree(curr->getLeft());
+    Drone* right = settleSubtree(curr->getRight());
+    return join(left, curr, right);
 }
 
-//updateHeight
-//updates the height of the structure
-void Show::updateHeight(Drone* aDrone){
-    //if statement checks to ensure that aDrone is not a nullptr
-    if (aDrone != nullptr){
-        int leftHeight = ((aDrone->getLeft() == nullptr) ? -1 : aDrone->getLeft()->getHeight());
-        int rightHeight = ((aDrone->getRight() == nullptr) ? -1 : aDrone->getRight()->getHeight());
+//releaseSubtree
+//hands every drone of the subtree back to the pool
+void Show::releaseSubtree(Drone* curr){
+    if (curr != nullptr){
+        curr->pushTag();
+        releaseSubtree(curr->getLeft());
+        releaseSubtree(curr->getRight());
+        if (m_indexed){
+            unindexDrone(curr->getID(), curr->getType(), curr->getState());
+        }
+        m_pool.release(curr);
+    }
+}
 
-        //newHeight is one plus the ternary operator depending on which height is greater
-        //if leftHeight is greater, that is used, otherwise the rightHeight is used
-        int newHeight = 1 + ((leftHeight > rightHeight) ? leftHeight : rightHeight);
-        aDrone->setHeight(newHeight); //aDrone's new height is set
+//countPages
+//passes the page of the parent and the pages touched so far down to each child
+void Show::countPages(const Drone* curr, uintptr_t parentPage, int numPages, double& total) const{
+    if (curr != nullptr){
+        uintptr_t page = reinterpret_cast<uintptr_t>(curr) / PAGE_BYTES;
+        numPages += ((numPages == 0) || (page != parentPage));
+        total += numPages;
+        countPages(curr->getLeft(), page, numPages, total);
+        countPages(curr->getRight(), page, numPages, total);
     }
 }
 
-//inorderList
-//Helper function which recurses and prints out each drone of the list in order
-void Show::inorderList(const Drone* curr) const{
-    //if curr is a nullptr, that means that it will seg fault, so if statement checks for that
+//distanceBetween
+//the drones may be in different slabs, so the addresses are compared as integers rather than subtracted as pointers
+double Show::distanceBetween(const Drone* lhs, const Drone* rhs){
+    uintptr_t left = reinterpret_cast<uintptr_t>(lhs);
+    uintptr_t right = reinterpret_cast<uintptr_t>(rhs);
+    return (double)((left > right) ? left - right : right - left) / sizeof(Drone);
+}
+
+//vebOrder
+//lists the top half of the subtree's levels as its own van Emde Boas tree, then every subtree hanging below it
+//so each small subtree, at every scale, ends up in one contiguous block
+void Show::vebOrder(Drone* curr, int levels, vector<Drone*>& nodes){
     if (curr == nullptr){
         return;
     }
-    else{
-        //follows left, middle, then right principle of inorder traversal
-        inorderList(curr->getLeft());
-        //node output
-        //getStateStr and getTypeStr used since it displays the data associated with the enum
-        cout << curr->getID() << ":" << curr->getStateStr() << ":" << curr->getTypeStr() << endl;
-        inorderList(curr->getRight());
+    if (levels == 1){
+        nodes.push_back(curr);
+        return;
+    }
+    int top = levels / 2;
+    vebOrder(curr, top, nodes);
+    vector<Drone*> roots;
+    collectDepth(curr, top, roots);
+    for (unsigned int i = 0; i < roots.size(); i++){
+        vebOrder(roots[i], levels - top, nodes);
     }
 }
 
-//lightsOff
-//Helper function to remove drone with lights off
-Drone* Show::lightsOff(Drone* curr){
-    //if curr is nullptr, that means that there's nothing to be done
-    if (curr == nullptr){
+//collectDepth
+//appends the drones exactly depth levels below curr, left to right
+void Show::collectDepth(Drone* curr, int depth, vector<Drone*>& nodes){
+    if (curr != nullptr){
+        if (depth == 0){
+            nodes.push_back(curr);
+        }
+        else{
+            collectDepth(curr->m_left, depth - 1, nodes);
+            collectDepth(curr->m_right, depth - 1, nodes);
+        }
+    }
+}
+
+//relocateStragglers
+//moves every drone of the subtree that is still in an old slab, repointing the link to it
+void Show::relocateStragglers(DroneLink* link){
+    if (*link != nullptr){
+        if (!m_pool.isRelocated(*link)){
+            *link = m_pool.relocate(*link);
+        }
+        relocateStragglers(&(*link)->m_left);
+        relocateStragglers(&(*link)->m_right);
+    }
+}
+
+//flattenInorder
+//appends every node of the subtree to nodes, in order of ID
+void Show::flattenInorder(Drone* curr, vector<Drone*>& nodes){
+    if (curr != nullptr){
+        curr->pushTag();
+        flattenInorder(curr->getLeft(), nodes);
+        nodes.push_back(curr);
+        flattenInorder(curr->getRight(), nodes);
+    }
+}
+
+//buildBalanced
+//links an array of nodes sorted by ID into a balanced tree, the middle node becomes the root
+//both halves differ in size by at most one, so their heights differ by at most one and no restructure is needed
+//large halves are built on separate threads, since the two subtrees share no nodes
+Drone* Show::buildBalanced(Drone** nodes, int numDrones, int numThreads){
+    if (numDrones == 0){
         return nullptr;
     }
+    int mid = numDrones / 2;
+    Drone* curr = nodes[mid];
+
+    //if statement checks if the left half is worth handing to another thread
+    if ((numThreads > 1) && (numDrones >= PARALLEL_BUILD)){
+        Drone* left = nullptr;
+        thread leftBuilder([&](){left = buildBalanced(nodes, mid, numThreads / 2);});
+        curr->setRight(buildBalanced(nodes + mid + 1, numDrones - mid - 1, numThreads - numThreads / 2));
+        leftBuilder.join();
+        curr->setLeft(left);
+    }
     else{
-        //postorder traversal used
-        curr->setLeft(lightsOff(curr->getLeft()));
-        curr->setRight(lightsOff(curr->getRight()));
-        //if the state of curr is lightsoff, then the drone is removed
-        updateHeight(curr);
-        if (curr->getState() == LIGHTOFF){
-            return recursiveRemove(curr->getID(), curr);
+        curr->setLeft(buildBalanced(nodes, mid, 1));
+        curr->setRight(buildBalanced(nodes + mid + 1, numDrones - mid - 1, 1));
+    }
+
+    updateHeight(curr);
+    updateCounts(curr);
+    return curr;
+}
+
+//rebuildKept
+//compacts the kept nodes to the front, releases the others, and links the survivors into a balanced tree
+//the surviving nodes are reused as they are, so nothing is reallocated
+int Show::rebuildKept(vector<Drone*>& nodes, const vector<char>& keep, int numThreads){
+    int numKept = 0;
+    for (unsigned int i = 0; i < nodes.size(); i++){
+        if (keep[i]){
+            nodes[numKept++] = nodes[i];
         }
         else{
-            return curr;
+            if (m_indexed){
+                unindexDrone(nodes[i]->getID(), nodes[i]->getType(), nodes[i]->getState());
+            }
+            m_pool.release(nodes[i]);
         }
     }
+    int numRemoved = nodes.size() - numKept;
+
+    //if nothing was removed the tree is left exactly as it was
+    if (numRemoved > 0){
+        invalidateCache();
+        m_root = buildBalanced(nodes.data(), numKept, numThreads);
+    }
+    settleInline();
+    return numRemoved;
 }
 
 //preorderAssignment
@@ -539,8 +1672,9 @@ Drone* Show::preOrderAssignment(const Drone* rhsDrone){
         return nullptr;
     }
     else{
+        reveal(rhsDrone);
         //curr set to newDrone
-        Drone* curr= new Drone(rhsDrone->getID(), rhsDrone->getType(), rhsDrone->getState());
+        Drone* curr = m_pool.allocate(rhsDrone->getID(), rhsDrone->getType(), rhsDrone->getState());
         
         //preorderAssignment called with rhsDrone going to the left first then right
         //set as left and right subtrees of curr
@@ -548,31 +1682,399 @@ Drone* Show::preOrderAssignment(const Drone* rhsDrone){
         curr->setRight(preOrderAssignment(rhsDrone->getRight()));
         
         
-        updateHeight(curr); //curr height updated at end to ensure height updated properly
+        curr->setHeight(rhsDrone->getHeight()); //the height is copied, since a WAVL rank cannot be recomputed from the children
+        updateCounts(curr);
         return curr; //curr is returned
     }
 }
 
-//postOrderCount
-//helper function which counts the number of drones of a certain type
-int Show::postOrderCount(LIGHTCOLOR color, Drone* curr) const{
-    if (curr == nullptr){
-        return 0;
+//countBelow
+//counts the drones of a color and state with IDs less than id
+//every time the descent goes right, the whole left subtree and the current drone are below id
+int Show::countBelow(LIGHTCOLOR color, STATE state, int id) const{
+    int count = 0;
+    Drone* curr = m_root;
+    while (curr != nullptr){
+        reveal(curr);
+        if (curr->getID() < id){
+            count += ((curr->getLeft() == nullptr) ? 0 : curr->getLeft()->getCount(color, state));
+            count += (((curr->getType() == color) && (curr->getState() == state)) ? 1 : 0);
+            curr = curr->getRight();
+        }
+        else{
+            curr = curr->getLeft();
+        }
     }
-    else{
-        //left count and right count are declared and initialized
-        int leftCount = postOrderCount(color, curr->getLeft());
-        int rightCount = postOrderCount(color, curr->getRight());
-        
-        //count declared and initlaized
-        int count = leftCount + rightCount;
-        
-        //if statement checks if the type is equal to the type provided, and adds one to the count based on that
-        if (curr->getType() == color){
-            return ++count;
+    return count;
+}
+
+//setInlineLimits
+//the limits are clamped to the inline array, and demoteBelow is kept below promoteAbove so a show cannot flip back and forth
+void Show::setInlineLimits(int promoteAbove, int demoteBelow){
+    m_promoteAbove = ((promoteAbove < 0) ? 0 : ((promoteAbove > INLINE_CAPACITY) ? INLINE_CAPACITY : promoteAbove));
+    m_demoteBelow = ((demoteBelow < 0) ? 0 : ((demoteBelow > m_promoteAbove) ? m_promoteAbove : demoteBelow));
+    //if statement takes the inline array from the arena the first time inline mode is turned on
+    if ((m_inline == nullptr) && (m_promoteAbove > 0)){
+        m_inline = DronePool::takeBlock(INLINE_CAPACITY, m_inlineBlock);
+    }
+    //if statement checks if an empty show should start out inline
+    if ((m_root == nullptr) && !(m_inlineMode) && (m_promoteAbove > 0)){
+        m_pool.releaseAll();
+        m_compactCursor = NOT_COMPACTING;
+        m_inlineMode = true;
+        m_numInline = 0;
+    }
+    settleInline();
+}
+
+//promote
+//allocates a pool drone for each inline drone and links them the same way
+void Show::promote(){
+    Drone* nodes[INLINE_CAPACITY];
+    for (int i = 0; i < m_numInline; i++){
+        nodes[i] = m_pool.allocate(m_inline[i].getID(), m_inline[i].getType(), m_inline[i].getState());
+    }
+    invalidateCache();
+    m_root = buildBalanced(nodes, m_numInline, 1);
+    m_inlineMode = false;
+    m_numInline = 0;
+}
+
+//demote
+//copies the drones into the inline array in order, then frees every slab of the pool
+void Show::demote(){
+    vector<Drone*> nodes;
+    flattenInorder(m_root, nodes);
+    for (unsigned int i = 0; i < nodes.size(); i++){
+        m_inline[i] = Drone(nodes[i]->getID(), nodes[i]->getType(), nodes[i]->getState());
+    }
+    m_numInline = nodes.size();
+    m_pool.releaseAll();
+    m_compactCursor = NOT_COMPACTING;
+    m_inlineMode = true;
+    relinkInline();
+}
+
+//settleInline
+//with inline mode off, an inline show is promoted, otherwise the size is checked against the limits
+void Show::settleInline(){
+    if (m_inlineMode && ((m_promoteAbove == 0) || (m_numInline > m_promoteAbove))){
+        promote();
+    }
+    else if (!(m_inlineMode) && (m_promoteAbove > 0) && (m_pool.inUse() < m_demoteBelow)){
+        demote();
+    }
+}
+
+//relinkInline
+//the array is already in order, so buildBalanced links it and sets every height and counter
+void Show::relinkInline(){
+    Drone* nodes[INLINE_CAPACITY];
+    for (int i = 0; i < m_numInline; i++){
+        nodes[i] = &m_inline[i];
+    }
+    invalidateCache();
+    m_root = buildBalanced(nodes, m_numInline, 1);
+}
+
+//searchInline
+//binary search of the inline array
+int Show::searchInline(int id) const{
+    int lo = 0;
+    int hi = m_numInline;
+    while (lo < hi){
+        int mid = (lo + hi) / 2;
+        if (m_inline[mid].getID() < id){
+            lo = mid + 1;
         }
         else{
-            return count;
+            hi = mid;
         }
     }
-}
\ No newline at end of file
+    return lo;
+}
+
+//locate
+//the drone with exactly this ID, nullptr if it is not in the tree
+const Drone* Show::locate(int id) const{
+    const Drone* curr = m_root;
+    while ((curr != nullptr) && (curr->getID() != id)){
+        reveal(curr);
+        curr = ((id < curr->getID()) ? curr->getLeft() : curr->getRight());
+    }
+    return curr;
+}
+
+//indexDrone
+//adds the ID to the bitmaps of its color and state
+void Show::indexDrone(int id, LIGHTCOLOR type, STATE state){
+    m_colorIndex[type].add(id);
+    m_stateIndex[state].add(id);
+}
+
+//unindexDrone
+//takes the ID out of the bitmaps of its color and state
+void Show::unindexDrone(int id, LIGHTCOLOR type, STATE state){
+    m_colorIndex[type].remove(id);
+    m_stateIndex[state].remove(id);
+}
+
+//rebuildIndexes
+//empties the bitmaps and adds every drone in order
+void Show::rebuildIndexes(){
+    for (int i = 0; i < NUMCOLORS; i++){
+        m_colorIndex[i].clear();
+    }
+    for (int i = 0; i < NUMSTATES; i++){
+        m_stateIndex[i].clear();
+    }
+    for (const Drone& curr : *this){
+        indexDrone(curr.getID(), curr.getType(), curr.getState());
+    }
+}
+
+//DronePool arena
+//one reservation of address space shared by every pool, pages are only backed once drones are written to them
+Drone* DronePool::s_drones = nullptr;
+uint64_t* DronePool::s_counts = nullptr;
+uint8_t* DronePool::s_tags = nullptr;
+uint32_t DronePool::s_used = 0;
+vector<uint32_t> DronePool::s_freeBlocks[32];
+mutex DronePool::s_lock;
+
+//DronePool constructor
+//starts with no slabs, the first allocation creates one
+DronePool::DronePool(){
+    m_freeList = nullptr;
+    m_next = nullptr;
+    m_slabEnd = nullptr;
+    m_capacity = 0;
+    m_inUse = 0;
+    m_relocating = false;
+    m_moveNext = nullptr;
+    m_moveSize = 0;
+}
+
+//DronePool destructor
+//hands every slab back to the arena
+DronePool::~DronePool(){
+    releaseAll();
+}
+
+//allocate
+//hands out a drone, recycled drones are used first so the slabs stay dense
+Drone* DronePool::allocate(int id, LIGHTCOLOR type, STATE state){
+    Drone* aDrone;
+    //if statement checks if a released drone can be reused
+    if (m_freeList != nullptr){
+        aDrone = m_freeList;
+        m_freeList = m_freeList->getLeft();
+    }
+    else{
+        //if the newest slab is used up, a slab as large as the whole pool is added so growth is geometric
+        if (m_next == m_slabEnd){
+            addSlab((m_capacity < MIN_SLAB) ? MIN_SLAB : m_capacity);
+        }
+        aDrone = m_next++;
+    }
+    *aDrone = Drone(id, type, state);
+    aDrone->resetCounts();
+    m_inUse++;
+    return aDrone;
+}
+
+//release
+//returns a drone to the free list, its memory stays in the slab until releaseAll
+void DronePool::release(Drone* aDrone){
+    aDrone->setLeft(m_freeList);
+    m_freeList = aDrone;
+    m_inUse--;
+}
+
+//reserve
+//adds a single slab large enough that numDrones drones fit without another allocation
+void DronePool::reserve(int numDrones){
+    //every drone not in use is either on the free list or unused in the newest slab
+    if (numDrones > m_capacity){
+        addSlab(numDrones - m_capacity);
+    }
+}
+
+//releaseAll
+//hands every slab back to the arena, which is O(number of slabs) instead of O(number of drones)
+void DronePool::releaseAll(){
+    for (unsigned int i = 0; i < m_slabs.size(); i++){
+        giveBlock(m_slabs[i], m_slabSizes[i]);
+    }
+    m_slabs.clear();
+    m_slabSizes.clear();
+    for (unsigned int i = 0; i < m_newSlabs.size(); i++){
+        giveBlock(m_newSlabs[i].first, m_newSlabSizes[i]);
+    }
+    m_newSlabs.clear();
+    m_newSlabSizes.clear();
+    m_freeList = nullptr;
+    m_next = nullptr;
+    m_slabEnd = nullptr;
+    m_capacity = 0;
+    m_inUse = 0;
+    m_relocating = false;
+    m_moveNext = nullptr;
+    m_moveSize = 0;
+}
+
+//addSlab
+//takes a new slab from the arena, the unused remainder of the previous slab is moved to the free list
+void DronePool::addSlab(int numDrones){
+    //while loop hands the leftover drones of the old slab to the free list so none are lost
+    while (m_next != m_slabEnd){
+        Drone* leftover = m_next++;
+        leftover->setLeft(m_freeList);
+        m_freeList = leftover;
+    }
+    int blockSize;
+    Drone* slab = takeBlock(numDrones, blockSize);
+    m_slabs.push_back(slab);
+    m_slabSizes.push_back(blockSize);
+    m_next = slab;
+    m_slabEnd = slab + numDrones;
+    m_capacity += numDrones;
+}
+
+//beginRelocation
+//the new slabs are only made once drones are moved into them, the first one holds numDrones
+//if a relocation is already under way, its new slabs are treated as old ones from here on
+void DronePool::beginRelocation(int numDrones){
+    for (unsigned int i = 0; i < m_newSlabs.size(); i++){
+        m_slabs.push_back(m_newSlabs[i].first);
+        m_slabSizes.push_back(m_newSlabSizes[i]);
+    }
+    m_newSlabs.clear();
+    m_newSlabSizes.clear();
+    m_relocating = true;
+    m_moveNext = nullptr;
+    m_moveSize = ((numDrones < MIN_SLAB) ? MIN_SLAB : numDrones);
+}
+
+//relocate
+//copies the drone, links, counters, and tag and all, into the next new slot, the caller repoints whatever linked to the old copy
+//the old copy is not put on the free list, since its slab goes back to the arena in finishRelocation
+Drone* DronePool::relocate(const Drone* aDrone){
+    //if the newest relocation slab is full, another is added, half the size of the ones so far
+    if (m_newSlabs.empty() || (m_moveNext == m_newSlabs.back().second)){
+        int blockSize;
+        Drone* slab = takeBlock(m_moveSize, blockSize);
+        m_newSlabs.push_back(make_pair(slab, slab + m_moveSize));
+        m_newSlabSizes.push_back(blockSize);
+        m_moveNext = slab;
+        m_capacity += m_moveSize;
+        m_moveSize = ((m_moveSize / 2 < MIN_SLAB) ? MIN_SLAB : m_moveSize / 2);
+    }
+    *m_moveNext = *aDrone;
+    uint64_t* counts = countsOf(m_moveNext);
+    const uint64_t* oldCounts = countsOf(aDrone);
+    counts[0] = oldCounts[0];
+    counts[1] = oldCounts[1];
+    m_moveNext->setTag(aDrone->getTag());
+    return m_moveNext++;
+}
+
+//isRelocated
+//checks the drone's address against the few new slabs
+bool DronePool::isRelocated(const Drone* aDrone) const{
+    for (unsigned int i = 0; i < m_newSlabs.size(); i++){
+        if ((aDrone >= m_newSlabs[i].first) && (aDrone < m_newSlabs[i].second)){
+            return true;
+        }
+    }
+    return false;
+}
+
+//finishRelocation
+//hands every old slab back to the arena and keeps only the free drones that are in the new slabs
+//the unused end of the newest relocation slab is where the next allocations come from
+void DronePool::finishRelocation(){
+    //while loop walks the free list before anything is given back, keeping the drones in the new slabs
+    Drone* kept = nullptr;
+    Drone* curr = m_freeList;
+    while (curr != nullptr){
+        Drone* next = curr->getLeft();
+        if (isRelocated(curr)){
+            curr->setLeft(kept);
+            kept = curr;
+        }
+        curr = next;
+    }
+    m_freeList = kept;
+
+    for (unsigned int i = 0; i < m_slabs.size(); i++){
+        giveBlock(m_slabs[i], m_slabSizes[i]);
+    }
+    m_slabs.clear();
+    m_slabSizes.clear();
+    m_capacity = 0;
+    for (unsigned int i = 0; i < m_newSlabs.size(); i++){
+        m_slabs.push_back(m_newSlabs[i].first);
+        m_slabSizes.push_back(m_newSlabSizes[i]);
+        m_capacity += m_newSlabs[i].second - m_newSlabs[i].first;
+    }
+
+    m_next = m_moveNext;
+    m_slabEnd = (m_newSlabs.empty() ? nullptr : m_newSlabs.back().second);
+    m_newSlabs.clear();
+    m_newSlabSizes.clear();
+    m_relocating = false;
+    m_moveNext = nullptr;
+    m_moveSize = 0;
+}
+
+//takeBlock
+//hands out a released block of the right size, or carves a new one from the end of the arena
+//block sizes are powers of two so released blocks can be reused by any later slab of the same size
+Drone* DronePool::takeBlock(int numDrones, int& blockSize){
+    int order = 0;
+    while ((1 << order) < ((numDrones < ARENA_BLOCK) ? ARENA_BLOCK : numDrones)){
+        order++;
+    }
+    blockSize = 1 << order;
+
+    lock_guard<mutex> guard(s_lock);
+    //if statement reserves the arena the first time any pool needs a block
+    if (s_drones == nullptr){
+        void* drones = mmap(nullptr, (size_t)ARENA_DRONES * sizeof(Drone), PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        void* counts = mmap(nullptr, (size_t)ARENA_DRONES * 2 * sizeof(uint64_t), PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        void* tags = mmap(nullptr, (size_t)ARENA_DRONES * sizeof(uint8_t), PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if ((drones == MAP_FAILED) || (counts == MAP_FAILED) || (tags == MAP_FAILED)){
+            throw bad_alloc();
+        }
+        s_drones = static_cast<Drone*>(drones);
+        s_counts = static_cast<uint64_t*>(counts);
+        s_tags = static_cast<uint8_t*>(tags);
+        s_used = 1;//index 0 is the null link
+    }
+    if (!s_freeBlocks[order].empty()){
+        uint32_t first = s_freeBlocks[order].back();
+        s_freeBlocks[order].pop_back();
+        return s_drones + first;
+    }
+    if ((uint64_t)s_used + blockSize > ARENA_DRONES){
+        throw bad_alloc();
+    }
+    uint32_t first = s_used;
+    s_used += blockSize;
+    return s_drones + first;
+}
+
+//giveBlock
+//returns a block to the arena, where it waits for the next slab of the same size
+void DronePool::giveBlock(Drone* block, int blockSize){
+    int order = 0;
+    while ((1 << order) < blockSize){
+        order++;
+    }
+    lock_guard<mutex> guard(s_lock);
+    s_freeBlocks[order].push_back(indexOf(block));
+}
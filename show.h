@@ -2,42 +2,92 @@
 #ifndef SHOW_H
 #define SHOW_H
 #include <iostream>
+#include <vector>
+#include <thread>
+#include <random>
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include "frozenshow.h"
+#include "dronebitmap.h"
+#include "treecore.h"
 using namespace std;
 class Grader;//this class is for grading purposes, no need to do anything
 class Tester;//this is your tester class, you add your test functions in this class
 class Show;
 enum STATE {LIGHTON, LIGHTOFF};
 enum LIGHTCOLOR {RED,GREEN,BLUE};
+enum INSERTRESULT {INSERTED, DUPLICATE, INVALID};//outcome reported by Show::insert
+enum REMOVERESULT {REMOVED, ABSENT};//outcome reported by Show::remove
+enum LAYOUT {INORDER, VANEMDEBOAS};//order Show::compact lays the drones out in memory
+enum BALANCE {AVL, WAVL, ADAPTIVE};//how Show keeps its tree balanced
+enum SIDE {LEFTSIDE, RIGHTSIDE};//which end of the tree a finger follows
+enum OPKIND {INSERTOP, REMOVEOP, SETSTATEOP};//what one record of a batch passed to Show::apply does
+const int NUMCOLORS = 3;//the number of LIGHTCOLOR values
+const int NUMSTATES = 2;//the number of STATE values
 const int MINID = 10000;
 const int MAXID = 99999;
+const int NO_DRONE = -1;//returned by navigation that reports IDs when there is no such drone
 #define DEFAULT_HEIGHT 0
 #define DEFAULT_ID 0
 #define DEFAULT_LIGHT RED
 #define DEFAULT_STATE LIGHTON
+#define MIN_SLAB 64 //the smallest number of drones a pool slab holds
+#define PARALLEL_BUILD 16384 //rosters at least this large are built on more than one thread
+#define PAGE_BYTES 4096 //the page size descentPages measures with
+#define NOT_COMPACTING -1 //the compaction cursor between incremental compactions
+#define INLINE_CAPACITY 32 //the most drones a Show can hold inline, without any pool slab
+#define FEW_REMOVALS 16 //with indexes, removeLightOff removes one at a time while under 1 in this many drones are off
+#define EMPTY_EPOCH (~0ULL) //the epoch of an empty hot cache slot, m_cacheEpoch never counts up to it
+#define HIT_LIMIT 65535 //an adaptive show halves every access count once one reaches this, so old traffic fades
+#define SORT_BITS 11 //the bits of an ID each pass of apply's radix sort handles, three passes cover all 32
+#define DIRTY_HEIGHT 63 //the height a burst marks drones with once their subtree changed, the largest a drone can hold
+#define ARENA_DRONES (1 << 24) //the most drones that can exist at once across every Show
+#define ARENA_BLOCK 32 //the smallest block of drones the arena hands to a pool
+class Drone;
+//DroneLink
+//a child link stored as a 32-bit index into the drone arena instead of a 64-bit pointer, index 0 is null
+//it reads and writes like a Drone*, so descent paths can hold the address of a link the same way
+class DroneLink{
+    public:
+    DroneLink() : m_index(0) {}
+    operator Drone*() const;
+    Drone* operator->() const;
+    DroneLink& operator=(Drone* aDrone);
+    private:
+    uint32_t m_index;//the arena index of the linked drone, 0 if there is none
+};
 class Drone{
     public:
     friend class Show;
+    friend class DronePool;
     friend class Grader;
     friend class Tester;
-    Drone(int id, LIGHTCOLOR type = DEFAULT_LIGHT, STATE state = DEFAULT_STATE)
-        :m_id(id),m_type(type), m_state(state) {
-            m_left = nullptr;
-            m_right = nullptr;
-            m_height = DEFAULT_HEIGHT;
-        }
+    friend class DroneTraits;
+    Drone(int id, LIGHTCOLOR type = DEFAULT_LIGHT, STATE state = DEFAULT_STATE){
+        m_word = 0;
+        setID(id);
+        setType(type);
+        setState(state);
+        setHeight(DEFAULT_HEIGHT);
+    }
     Drone(){
-        m_id = DEFAULT_ID;
-        m_type = DEFAULT_LIGHT;
-        m_state = DEFAULT_STATE;
-        m_left = nullptr;
-        m_right = nullptr;
-        m_height = DEFAULT_HEIGHT;
-    }
-    int getID() const {return m_id;}
-    STATE getState() const {return m_state;}
+        m_word = 0;
+        setID(DEFAULT_ID);
+        setType(DEFAULT_LIGHT);
+        setState(DEFAULT_STATE);
+        setHeight(DEFAULT_HEIGHT);
+    }
+    int getID() const {//an ID outside [MINID, MAXID] cannot be stored, it reads back as DEFAULT_ID
+        int code = getField(ID_SHIFT, ID_MASK);
+        return ((code == (int)ID_MASK) ? DEFAULT_ID : MINID + code);
+    }
+    STATE getState() const {return static_cast<STATE>(getField(STATE_SHIFT, CODE_MASK));}
     string getStateStr() const {
         string text = "";
-        switch (m_state)
+        switch (getState())
         {
         case LIGHTOFF:text = "LIGHTOFF";break;
         case LIGHTON:text = "LIGHTON";break;
@@ -45,10 +95,10 @@ class Drone{
         }
         return text;
     }
-    LIGHTCOLOR getType() const {return m_type;}
+    LIGHTCOLOR getType() const {return static_cast<LIGHTCOLOR>(getField(TYPE_SHIFT, CODE_MASK));}
     string getTypeStr() const {
         string text = "";
-        switch (m_type)
+        switch (getType())
         {
         case RED:text = "RED";break;
         case GREEN:text = "GREEN";break;
@@ -58,42 +108,519 @@ class Drone{
         return text
         ;
     }
-    int getHeight() const {return m_height;}
+    int getHeight() const {return getField(HEIGHT_SHIFT, HEIGHT_MASK);}
+    int getCount(LIGHTCOLOR type, STATE state) const;//drones of that color and state in this subtree
+    int getSize() const;//the number of drones in this subtree, including this one
     Drone* getLeft() const {return m_left;}
     Drone* getRight() const {return m_right;}
-    void setID(const int id){m_id=id;}
-    void setState(STATE state){m_state=state;}
-    void setType(LIGHTCOLOR type){m_type=type;}
-    void setHeight(int height){m_height=height;}
+    void setID(const int id){setField(ID_SHIFT, ID_MASK, (((id >= MINID) && (id <= MAXID)) ? id - MINID : (int)ID_MASK));}
+    //an out of range state or color is stored as INVALID_CODE, so it still reads back as invalid
+    void setState(STATE state){setField(STATE_SHIFT, CODE_MASK, (((state == LIGHTON) || (state == LIGHTOFF)) ? state : INVALID_CODE));}
+    void setType(LIGHTCOLOR type){setField(TYPE_SHIFT, CODE_MASK, (((type >= RED) && (type <= BLUE)) ? type : INVALID_CODE));}
+    void setHeight(int height){setField(HEIGHT_SHIFT, HEIGHT_MASK, ((height < 0) ? 0 : ((height > (int)HEIGHT_MASK) ? (int)HEIGHT_MASK : height)));}
     void setLeft(Drone* left){m_left=left;}
     void setRight(Drone* right){m_right=right;}
     private:
-    int m_id;
-    LIGHTCOLOR m_type;
-    STATE m_state;
-    Drone* m_left;//the pointer to the left child in the BST
-    Drone* m_right;//the pointer to the right child in the BST
-    int m_height;//the height of node in the BST
+    //m_word packs the ID as an offset from MINID into bits 0-16, then the color, state, height, and a tagged flag above it
+    static const int ID_SHIFT = 0;
+    static const int TYPE_SHIFT = 17;
+    static const int STATE_SHIFT = 19;
+    static const int HEIGHT_SHIFT = 21;
+    static const int TAGGED_SHIFT = 27;//set while the arena holds a tag for this drone, so untagged drones never read it
+    static const uint32_t ID_MASK = (1 << 17) - 1;//MAXID - MINID fits in 17 bits, the all ones code marks an invalid ID
+    static const uint32_t CODE_MASK = 3;//color and state get two bits each
+    static const uint32_t HEIGHT_MASK = 63;//an AVL tree of MAXID drones is far shorter than 63
+    static const int INVALID_CODE = 3;
+    //the subtree counters are cold data kept by the arena, three 21-bit counters to a word
+    //every counter stays below 2^21, so whole words can be added without one field carrying into the next
+    static const int COUNT_BITS = 21;
+    static const int COUNTS_PER_WORD = 3;
+    static const uint64_t COUNT_MASK = (1 << COUNT_BITS) - 1;
+
+    uint32_t m_word;//ID, color, state, height, and tagged flag
+    DroneLink m_left;//the index of the left child in the BST
+    DroneLink m_right;//the index of the right child in the BST
+
+    int getField(int shift, uint32_t mask) const {return (int)((m_word >> shift) & mask);}
+    void setField(int shift, uint32_t mask, int value){m_word = (m_word & ~(mask << shift)) | (((uint32_t)value & mask) << shift);}
+    int getTag() const;//the pending range update tag, always 0 for a drone outside the arena
+    void setTag(int tag);//a tag other than 0 only for arena drones, like the counters
+
+    //resetCounts
+    //counts only this drone, as if it were a leaf
+    void resetCounts();
+
+    //addCounts
+    //adds a child's counters to this drone's
+    void addCounts(const Drone* child);
+
+    //moveCount
+    //moves one drone of the given color from one state's counter to the other's
+    void moveCount(LIGHTCOLOR type, STATE from, STATE to);
+
+    //tags
+    //a tag is a recoloring and state change the drones below this one have yet to take, this drone and its counters already have
+    //bits 0-5 hold how far each color moves, mod NUMCOLORS, and bits 6-7 whether each state flips, so tag 0 changes nothing
+    static int tagType(int tag, int type) {return (type + ((tag >> (2 * type)) & 3)) % NUMCOLORS;}
+    static int tagState(int tag, int state) {return state ^ ((tag >> (2 * NUMCOLORS + state)) & 1);}
+    static int makeTag(const int types[], const int states[]){
+        int tag = 0;
+        for (int type = 0; type < NUMCOLORS; type++){
+            tag |= ((types[type] - type + NUMCOLORS) % NUMCOLORS) << (2 * type);
+        }
+        for (int state = 0; state < NUMSTATES; state++){
+            tag |= (states[state] ^ state) << (2 * NUMCOLORS + state);
+        }
+        return tag;
+    }
+    static int composeTags(int first, int then){//the tag for applying first and then then
+        int types[NUMCOLORS];
+        int states[NUMSTATES];
+        for (int type = 0; type < NUMCOLORS; type++){
+            types[type] = tagType(then, tagType(first, type));
+        }
+        for (int state = 0; state < NUMSTATES; state++){
+            states[state] = tagState(then, tagState(first, state));
+        }
+        return makeTag(types, states);
+    }
+
+    //applyTag
+    //changes this drone and every counter of its subtree in O(1), and holds the tag for its children
+    void applyTag(int tag);
+
+    //pushTag
+    //hands this drone's tag down to its children, after which they and their counters are current
+    void pushTag();
+};
+//DroneTraits
+//lets the tree kernels in treecore.h work on Drones, the pulled data is the color and state counters and the pushed data the range update tag
+class DroneTraits{
+    public:
+    typedef Drone Node;
+    typedef int Key;
+    typedef less<int> Compare;
+    static int key(const Drone* aDrone) {return aDrone->getID();}
+    static Drone* left(const Drone* aDrone) {return aDrone->getLeft();}
+    static Drone* right(const Drone* aDrone) {return aDrone->getRight();}
+    static void setLeft(Drone* aDrone, Drone* child) {aDrone->setLeft(child);}
+    static void setRight(Drone* aDrone, Drone* child) {aDrone->setRight(child);}
+    static int height(const Drone* aDrone) {return aDrone->getHeight();}
+    static void setHeight(Drone* aDrone, int height) {aDrone->setHeight(height);}
+    static void pull(Drone* aDrone){
+        aDrone->resetCounts();
+        if (aDrone->getLeft() != nullptr){
+            aDrone->addCounts(aDrone->getLeft());
+        }
+        if (aDrone->getRight() != nullptr){
+            aDrone->addCounts(aDrone->getRight());
+        }
+    }
+    static void push(Drone* aDrone) {aDrone->pushTag();}
+};
+typedef AvlPolicy<DroneTraits> DroneBalance;
+typedef TreeKernels<DroneTraits, DroneBalance> DroneKernels;
+typedef WavlPolicy<DroneTraits> DroneWavl;
+typedef TreeKernels<DroneTraits, DroneWavl> DroneWavlKernels;
+typedef RelaxedAvlPolicy<DroneTraits> DroneRelaxed;
+typedef TreeKernels<DroneTraits, DroneRelaxed> DroneRelaxedKernels;
+//DroneOp
+//one record of a roster update batch, the color and state are only read by the kinds that use them
+struct DroneOp{
+    OPKIND kind;
+    int id;
+    LIGHTCOLOR type;//read by INSERTOP
+    STATE state;//read by INSERTOP and SETSTATEOP
+};
+//CompactReport
+//locality of a Show before and after compact
+//a scan stride of 1 means an in order scan reads memory sequentially
+struct CompactReport{
+    double scanBefore;//average distance in drones between drones adjacent in ID order
+    double scanAfter;
+    double descentBefore;//average number of pages a search from the root touches
+    double descentAfter;
+};
+//DronePool
+//slab allocator which owns every Drone in a Show, freed drones are recycled through a free list
+//slabs are blocks of one shared arena, so a 32-bit index names any drone and links stay 4 bytes
+class DronePool{
+    public:
+    friend class Tester;
+    DronePool();
+    ~DronePool();
+    DronePool(const DronePool&) = delete;
+    DronePool& operator=(const DronePool&) = delete;
+    Drone* allocate(int id, LIGHTCOLOR type, STATE state);//hands out a recycled drone, or the next unused one in a slab
+    void release(Drone* aDrone);//returns a drone to the free list
+    void reserve(int numDrones);//ensures that numDrones drones can be held without another slab
+    void releaseAll();//hands every slab back to the arena at once, every drone handed out becomes invalid
+    int capacity() const {return m_capacity;}
+    int inUse() const {return m_inUse;}
+    void beginRelocation(int numDrones);//starts moving drones into new slabs, the first one sized for numDrones
+    Drone* relocate(const Drone* aDrone);//copies a drone into the next slot of the new slabs, the old copy is abandoned
+    bool isRelocated(const Drone* aDrone) const;//true if the drone is already in the new slabs
+    void finishRelocation();//hands every old slab back to the arena, the new slabs become the pool
+    bool relocating() const {return m_relocating;}
+    static Drone* drone(uint32_t index) {return ((index == 0) ? nullptr : s_drones + index);}//the arena drone with that index
+    static uint32_t indexOf(const Drone* aDrone) {return ((aDrone == nullptr) ? 0 : (uint32_t)(aDrone - s_drones));}
+    static uint64_t* countsOf(const Drone* aDrone);//the counter words of an arena drone, nullptr for a drone outside the arena
+    static uint8_t* tagOf(const Drone* aDrone);//the range update tag of an arena drone, nullptr for a drone outside the arena
+    static Drone* takeBlock(int numDrones, int& blockSize);//a block of at least numDrones arena drones, for slabs and for owners outside a pool
+    static void giveBlock(Drone* block, int blockSize);//returns a block from takeBlock to the arena
+
+    private:
+    vector<Drone*> m_slabs;//every slab taken from the arena, each is a contiguous block of drones
+    vector<int> m_slabSizes;//the arena block size of each slab
+    Drone* m_freeList;//released drones, chained through their left links
+    Drone* m_next;//the next never used drone within the newest slab
+    Drone* m_slabEnd;//one past the end of the newest slab
+    int m_capacity;//the total number of drones across all slabs
+    int m_inUse;//the number of drones currently handed out
+    bool m_relocating;//true between beginRelocation and finishRelocation
+    vector<pair<Drone*, Drone*> > m_newSlabs;//the start and end of every slab drones are being relocated into
+    vector<int> m_newSlabSizes;//the arena block size of each relocation slab
+    Drone* m_moveNext;//the next unused drone within the newest relocation slab
+    int m_moveSize;//the size of the next relocation slab
+
+    static Drone* s_drones;//the arena, reserved once and never moved, index 0 is never handed out
+    static uint64_t* s_counts;//two counter words for every arena drone, kept apart so the hot nodes stay small
+    static uint8_t* s_tags;//one range update tag for every arena drone, the drone word only has room for a flag saying there is one
+    static uint32_t s_used;//every index below this has been handed out at least once
+    static vector<uint32_t> s_freeBlocks[32];//released blocks, by log2 of their size
+    static mutex s_lock;//guards the arena, pools in different threads take blocks from it
+
+    void addSlab(int numDrones);//helper for allocate and reserve
+    static int64_t slotOf(const Drone* aDrone);//helper for countsOf and tagOf, the arena index of a drone, -1 outside the arena
 };
+
+//DroneLink conversions
+//an index becomes an address with one add, so following a link costs no more than a pointer load
+inline DroneLink::operator Drone*() const {return DronePool::drone(m_index);}
+inline Drone* DroneLink::operator->() const {return DronePool::drone(m_index);}
+inline DroneLink& DroneLink::operator=(Drone* aDrone){
+    m_index = DronePool::indexOf(aDrone);
+    return *this;
+}
+
+//slotOf
+//an address inside the arena is a whole number of drones from its start
+inline int64_t DronePool::slotOf(const Drone* aDrone){
+    uintptr_t offset = (uintptr_t)aDrone - (uintptr_t)s_drones;
+    if ((s_drones == nullptr) || (offset >= (uintptr_t)ARENA_DRONES * sizeof(Drone))){
+        return -1;
+    }
+    return (int64_t)(offset / sizeof(Drone));
+}
+
+//countsOf
+//a drone's counters sit at the same index in s_counts as the drone does in the arena
+inline uint64_t* DronePool::countsOf(const Drone* aDrone){
+    int64_t slot = slotOf(aDrone);
+    return ((slot < 0) ? nullptr : s_counts + 2 * slot);
+}
+
+//tagOf
+//a drone's tag sits at the same index in s_tags as the drone does in the arena
+inline uint8_t* DronePool::tagOf(const Drone* aDrone){
+    int64_t slot = slotOf(aDrone);
+    return ((slot < 0) ? nullptr : s_tags + slot);
+}
+
+//Drone counters
+//a drone outside the arena, like a copy in a buffer, has no counters and reports itself as a leaf
+inline int Drone::getCount(LIGHTCOLOR type, STATE state) const{
+    const uint64_t* counts = DronePool::countsOf(this);
+    if (counts == nullptr){
+        return (((type == getType()) && (state == getState())) ? 1 : 0);
+    }
+    int slot = type * NUMSTATES + state;
+    return (counts[slot / COUNTS_PER_WORD] >> ((slot % COUNTS_PER_WORD) * COUNT_BITS)) & COUNT_MASK;
+}
+inline int Drone::getSize() const{
+    const uint64_t* counts = DronePool::countsOf(this);
+    if (counts == nullptr){
+        return 1;
+    }
+    //the size is the sum of the six counters, since only valid drones are ever linked into a tree
+    uint64_t size = 0;
+    for (int i = 0; i < 2; i++){
+        size += (counts[i] & COUNT_MASK) + ((counts[i] >> COUNT_BITS) & COUNT_MASK) + ((counts[i] >> (2 * COUNT_BITS)) & COUNT_MASK);
+    }
+    return (int)size;
+}
+inline void Drone::resetCounts(){
+    uint64_t* counts = DronePool::countsOf(this);
+    counts[0] = 0;
+    counts[1] = 0;
+    int type = getField(TYPE_SHIFT, CODE_MASK);
+    int state = getField(STATE_SHIFT, CODE_MASK);
+    if ((type != INVALID_CODE) && (state != INVALID_CODE)){
+        int slot = type * NUMSTATES + state;
+        counts[slot / COUNTS_PER_WORD] = (uint64_t)1 << ((slot % COUNTS_PER_WORD) * COUNT_BITS);
+    }
+}
+inline void Drone::addCounts(const Drone* child){
+    uint64_t* counts = DronePool::countsOf(this);
+    const uint64_t* childCounts = DronePool::countsOf(child);
+    counts[0] += childCounts[0];
+    counts[1] += childCounts[1];
+}
+inline void Drone::moveCount(LIGHTCOLOR type, STATE from, STATE to){
+    uint64_t* counts = DronePool::countsOf(this);
+    int fromSlot = type * NUMSTATES + from;
+    int toSlot = type * NUMSTATES + to;
+    counts[fromSlot / COUNTS_PER_WORD] -= (uint64_t)1 << ((fromSlot % COUNTS_PER_WORD) * COUNT_BITS);
+    counts[toSlot / COUNTS_PER_WORD] += (uint64_t)1 << ((toSlot % COUNTS_PER_WORD) * COUNT_BITS);
+}
+
+//Drone tags
+//like the counters, a drone's tag is kept by the arena, the flag in m_word says whether there is one to read
+//a new drone starts with the flag clear, so whatever an earlier drone left in its arena slot is never read
+inline int Drone::getTag() const{
+    if (getField(TAGGED_SHIFT, 1) == 0){
+        return 0;
+    }
+    const uint8_t* tag = DronePool::tagOf(this);
+    return ((tag == nullptr) ? 0 : *tag);
+}
+inline void Drone::setTag(int tag){
+    if (tag != 0){
+        *DronePool::tagOf(this) = (uint8_t)tag;
+    }
+    setField(TAGGED_SHIFT, 1, (tag != 0));
+}
+inline void Drone::applyTag(int tag){
+    if (tag == 0){
+        return;
+    }
+    int type = getField(TYPE_SHIFT, CODE_MASK);
+    int state = getField(STATE_SHIFT, CODE_MASK);
+    if ((type != INVALID_CODE) && (state != INVALID_CODE)){
+        setField(TYPE_SHIFT, CODE_MASK, tagType(tag, type));
+        setField(STATE_SHIFT, CODE_MASK, tagState(tag, state));
+    }
+    uint64_t* counts = DronePool::countsOf(this);
+    uint64_t moved[2] = {0, 0};
+    for (int slot = 0; slot < NUMCOLORS * NUMSTATES; slot++){
+        uint64_t count = (counts[slot / COUNTS_PER_WORD] >> ((slot % COUNTS_PER_WORD) * COUNT_BITS)) & COUNT_MASK;
+        int target = tagType(tag, slot / NUMSTATES) * NUMSTATES + tagState(tag, slot % NUMSTATES);
+        moved[target / COUNTS_PER_WORD] += count << ((target % COUNTS_PER_WORD) * COUNT_BITS);
+    }
+    counts[0] = moved[0];
+    counts[1] = moved[1];
+    setTag(composeTags(getTag(), tag));
+}
+inline void Drone::pushTag(){
+    int tag = getTag();
+    if (tag != 0){
+        if (m_left != nullptr){
+            m_left->applyTag(tag);
+        }
+        if (m_right != nullptr){
+            m_right->applyTag(tag);
+        }
+        setTag(0);
+    }
+}
 class Show{
     public:
     friend class Grader;
     friend class Tester;
+
+    //const_iterator
+    //bidirectional iterator over the drones in ID order, holding the path from m_root instead of recursing
+    //any insert, remove, or other change to the tree invalidates every iterator
+    class const_iterator{
+        public:
+        typedef bidirectional_iterator_tag iterator_category;
+        typedef Drone value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const Drone* pointer;
+        typedef const Drone& reference;
+
+        const_iterator() : m_root(nullptr), m_depth(0) {}
+        reference operator*() const {return *m_path[m_depth - 1];}
+        pointer operator->() const {return m_path[m_depth - 1];}
+        bool operator==(const const_iterator& rhs) const {return current() == rhs.current();}
+        bool operator!=(const const_iterator& rhs) const {return current() != rhs.current();}
+        const_iterator& operator++(){
+            const Drone* curr = m_path[m_depth - 1];
+            //if there is a right subtree the next drone is its leftmost one
+            if (curr->getRight() != nullptr){
+                pushLeftmost(curr->getRight());
+            }
+            //otherwise the path is popped until it climbs out of a left subtree
+            else{
+                const Drone* child;
+                do{
+                    child = m_path[--m_depth];
+                } while ((m_depth > 0) && (m_path[m_depth - 1]->getRight() == child));
+            }
+            return *this;
+        }
+        const_iterator& operator--(){
+            //decrementing end gives the rightmost drone of the tree
+            if (m_depth == 0){
+                pushRightmost(m_root);
+                return *this;
+            }
+            const Drone* curr = m_path[m_depth - 1];
+            //if there is a left subtree the previous drone is its rightmost one
+            if (curr->getLeft() != nullptr){
+                pushRightmost(curr->getLeft());
+            }
+            //otherwise the path is popped until it climbs out of a right subtree
+            else{
+                const Drone* child;
+                do{
+                    child = m_path[--m_depth];
+                } while ((m_depth > 0) && (m_path[m_depth - 1]->getLeft() == child));
+            }
+            return *this;
+        }
+        const_iterator operator++(int){const_iterator old = *this; ++(*this); return old;}
+        const_iterator operator--(int){const_iterator old = *this; --(*this); return old;}
+
+        private:
+        friend class Show;
+        const Drone* m_root;//the root of the tree, needed to step back from end
+        const Drone* m_path[MAXDEPTH];//every drone from m_root down to the current one
+        int m_depth;//the number of drones on the path, 0 means end
+
+        explicit const_iterator(const Drone* root) : m_root(root), m_depth(0) {}
+        const Drone* current() const {return ((m_depth == 0) ? nullptr : m_path[m_depth - 1]);}
+        void pushLeftmost(const Drone* curr){
+            for (; curr != nullptr; curr = curr->getLeft()){
+                reveal(curr);
+                m_path[m_depth++] = curr;
+            }
+        }
+        void pushRightmost(const Drone* curr){
+            for (; curr != nullptr; curr = curr->getRight()){
+                reveal(curr);
+                m_path[m_depth++] = curr;
+            }
+        }
+    };
+    typedef const_iterator iterator;//drones are only ever viewed through iterators, never changed
+
     Show();
     ~Show();
     const Show & operator=(const Show & rhs);
-    void insert(const Drone& aDrone);
+    INSERTRESULT insert(const Drone& aDrone);
+    INSERTRESULT insert(int id, LIGHTCOLOR type = DEFAULT_LIGHT, STATE state = DEFAULT_STATE);//emplace style insert
+    INSERTRESULT insert(const_iterator hint, const Drone& aDrone);//hinted insert, no descent if the drone belongs right before hint
+    //an ID beyond either end of the tree is appended through a finger kept at that end, so end() is the hint for rising IDs
     void clear();
-    void remove(int id);
+    void reserve(int numDrones);//preallocates room for numDrones drones
+    template <class Iterator>
+    int bulkLoad(Iterator first, Iterator last, int numThreads = 0);//loads a roster of drones in linear time, returns how many were added
+    REMOVERESULT remove(int id);
     void dumpTree() const;
     void listDrones() const;
     bool setState(int id, STATE state);
     void removeLightOff();//removes all LIGHTOFF Drones from the tree
+    template <class Predicate>
+    int removeIf(Predicate shouldRemove, int numThreads = 1);//removes every drone the predicate holds for, returns how many were removed
     bool findDrone(int id) const;//returns true if the drone is in tree
+    void findDrones(const int ids[], int numIds, bool found[]) const;//batched findDrone, descents are interleaved so their misses overlap
+    void setStates(const pair<int, STATE> updates[], int numUpdates, bool changed[]);//batched setState, applied in order
+    void apply(const DroneOp ops[], int numOps, bool done[]);//applies a batch of inserts, removes, and state changes in one merge with the tree
+    //done[i] is what op i alone would have reported, true if it inserted, removed, or changed the state, taking the ops in order
+    int rank(int id) const;//the number of drones with IDs less than id, which is the position of id if it is in the tree
+    const Drone* select(int k) const;//the drone at position k in ID order, counting from 0, nullptr if out of range
+    int listDrones(int offset, int limit, Drone buffer[]) const;//copies up to limit drones starting at position offset, returns how many
+    const Drone* sampleDrone(mt19937& generator) const;//a uniformly random drone, nullptr if the tree is empty
+    const Drone* floor(int id) const;//the drone with the largest ID not above id, nullptr if there is none
+    const Drone* ceiling(int id) const;//the drone with the smallest ID not below id, nullptr if there is none
+    const Drone* successor(int id) const;//the drone with the smallest ID above id, nullptr if there is none
+    const Drone* predecessor(int id) const;//the drone with the largest ID below id, nullptr if there is none
+    template <class Function>
+    void forEachInRange(int loId, int hiId, Function visit) const;//calls visit on every drone with an ID in [loId, hiId], in order
+    int removeRange(int loId, int hiId);//removes every drone with an ID in [loId, hiId], returns how many were removed
+    void setStateRange(int loId, int hiId, STATE state);//sets the state of every drone with an ID in [loId, hiId] in O(log n)
+    void setTypeRange(int loId, int hiId, LIGHTCOLOR type);//sets the color of every drone with an ID in [loId, hiId] in O(log n)
+    void recolor(LIGHTCOLOR from, LIGHTCOLOR to);//turns every drone of one color into the other in O(1)
+    //these tag each subtree wholly in range instead of visiting its drones, and whatever passes a tagged drone hands its tag down,
+    //so iterators and other reads change the tree, and like an adaptive findDrone must not run on two threads at once
+    //with indexes the bitmaps are moved a container at a time as well
+    int countDrones() const;//the number of drones in the tree
     int countDrones(LIGHTCOLOR aColor) const;
+    int countDrones(STATE aState) const;
+    int countDrones(LIGHTCOLOR aColor, STATE aState, int loId, int hiId) const;//counts matching drones with IDs in [loId, hiId]
+    const_iterator begin() const;//the drone with the smallest ID
+    const_iterator end() const;//one past the drone with the largest ID
+    const_iterator lower_bound(int id) const;//the first drone with an ID not below id
+    const_iterator upper_bound(int id) const;//the first drone with an ID above id
+    FrozenShow freeze() const;//builds a read only snapshot for fast lookups in O(n), later changes do not reach it
+    CompactReport compact(LAYOUT layout = INORDER);//moves every drone into one contiguous slab in the given order, invalidating pointers and iterators
+    bool compactStep(int maxDrones);//incremental in order compaction, moves up to maxDrones drones per call, true once it is finished
+    double scanStride() const;//average distance in drones between drones adjacent in ID order
+    double descentPages() const;//average number of memory pages a search from the root touches
+    void setInlineLimits(int promoteAbove, int demoteBelow);//keeps up to promoteAbove drones inline, returning once under demoteBelow, 0 turns it off
+    bool isInline() const {return m_inlineMode;}
+    void enableIndexes();//builds color and state bitmaps in O(n), every change keeps them up to date from then on
+    void disableIndexes();//drops the bitmaps
+    bool hasIndexes() const {return m_indexed;}
+    void setBalance(BALANCE balance);//switches balancing, free from AVL, otherwise the tree is rebuilt in O(n)
+    //ADAPTIVE lets heights differ by four and lifts each drone findDrone or setState reaches above less used parents
+    //so lookups of hot drones get shorter, findDrone then changes the tree, so it must not run on two threads at once
+    BALANCE getBalance() const {return m_balance;}
+    static long long rotationCount();//the rotations done by this thread in every Show, a double rotation counts as two
+    void enableHotCache(int numSlots);//remembers the paths to recently used drones in numSlots slots, rounded up to a power of two
+    void disableHotCache();//drops the cache
+    //with the cache on, findDrone and setState on a remembered drone skip the descent, and findDrone writes the cache
+    long long cacheHits() const {return m_cacheHits;}
+    long long cacheMisses() const {return m_cacheMisses;}
+    void beginBurst();//inserts and removes stop rebalancing and counting until endBurst, lookups by ID and iterators work meanwhile
+    //during a burst anything reading the counters, such as countDrones, rank, or select, settles the tree first,
+    //so like an adaptive findDrone it changes the tree and must not run on two threads at once
+    void endBurst();//rebalances every subtree the burst changed in one pass
+    bool inBurst() const {return m_burst;}
+    template <class Function>
+    void forEachMatching(LIGHTCOLOR aColor, STATE aState, Function visit) const;//calls visit on every drone of that color and state, in order
+    template <class Function>
+    void forEachMatching(LIGHTCOLOR aColor, Function visit) const;//calls visit on every drone of that color, in order
+    template <class Function>
+    void forEachMatching(STATE aState, Function visit) const;//calls visit on every drone in that state, in order
 
     private:
-    Drone* m_root;//the root of the BST
+    //HotEntry
+    //one slot of the hot cache, the path is only used while epoch matches m_cacheEpoch
+    struct HotEntry{
+        int id;//DEFAULT_ID while the slot is empty
+        int depth;//the number of drones on the path
+        unsigned long long epoch;//m_cacheEpoch when the path was recorded, EMPTY_EPOCH while the slot is empty
+        Drone* path[MAXDEPTH];//every drone from m_root down to the drone itself
+    };
+    //Finger
+    //the links down one side of the tree to its smallest or largest drone, only used while epoch matches m_cacheEpoch
+    struct Finger{
+        DroneLink* path[MAXDEPTH];//every link from m_root down to the end drone
+        int depth;//the number of links on the path, 0 until it is first walked
+        unsigned long long epoch;//m_cacheEpoch when the path was walked
+    };
+    DroneLink m_root;//the root of the BST
+    DronePool m_pool;//owns the memory of every drone in the tree
+    bool m_inlineMode;//true while every drone lives in m_inline rather than the pool
+    int m_numInline;//the number of drones in m_inline, in order of ID
+    int m_promoteAbove;//an inline show moves to the pool once it holds more drones than this, 0 if inline mode is off
+    int m_demoteBelow;//a pooled show moves back inline once it holds fewer drones than this
+    Drone* m_inline;//small fleets in ID order, linked as a perfectly balanced tree so every walker works unchanged
+    int m_inlineBlock;//the arena block size of m_inline, which is only taken once inline mode is first turned on
+    int m_compactCursor;//the last ID compactStep moved, NOT_COMPACTING when no compaction is under way
+    bool m_indexed;//true while the bitmaps below are kept up to date
+    DroneBitmap m_colorIndex[NUMCOLORS];//the IDs of the drones of each color
+    DroneBitmap m_stateIndex[NUMSTATES];//the IDs of the drones in each state
+    BALANCE m_balance;//AVL keeps heights in the drones, WAVL keeps ranks there and rotates less on removes
+    vector<unsigned short> m_hits;//access counts by id - MINID while adaptive, empty otherwise
+    mutable vector<HotEntry> m_hotCache;//direct mapped by the low bits of the ID, empty while the cache is off
+    unsigned long long m_cacheEpoch;//bumped by every change that moves or frees a drone, which empties every slot at once
+    mutable long long m_cacheHits;//lookups answered by the hot cache
+    mutable long long m_cacheMisses;//lookups that had to descend
+    bool m_burst;//true between beginBurst and endBurst, while the drones above every change are marked DIRTY_HEIGHT
+    Finger m_fingers[2];//indexed by SIDE, kept up to date by the inserts that append through them
 
     void dump(Drone* aDrone) const;//helper for recursive traversal
 
@@ -102,16 +629,257 @@ class Show{
     // ***************************************************
     
     
-    Drone* recursiveInsert(const Drone& aDrone, Drone* curr); //helper for insert
-    void recursiveClear(Drone* aDrone); //helper for clear
-    Drone* recursiveRemove(int id, Drone* curr); //helper for remove
-    Drone* trinodeRestructure(Drone* zDrone); //helper for insert and remove
-    int checkBalance(Drone* curr); //helper for insert and remove
-    Drone* tallestChild(Drone* parentDrone); //helper for insert and remove, specifically trinodeRestructure
-    void updateHeight(Drone* aDrone); //helper for insert and remove
-    void inorderList(const Drone* curr) const; //helper for listing drones
-    Drone* lightsOff(Drone* curr); //helper for removeLightOff
+    int loadRoster(vector<Drone>& roster, int numThreads); //helper for bulkLoad, does all of the work once the range is copied
+    void flattenInorder(Drone* curr, vector<Drone*>& nodes); //helper for bulkLoad, lists every node in order
+    Drone* buildBalanced(Drone** nodes, int numDrones, int numThreads); //helper for bulkLoad, links sorted nodes into a balanced tree
+    //the balancing and join kernels are shared with every tree in treecore.h, these forward to the policy m_balance selects
+    void rebalancePath(DroneLink* path[], int depth){ //helper for insert and remove, walks a descent path back up
+        invalidateCache();
+        if (m_burst){
+            relaxPath(path, depth);
+        }
+        else if (m_balance == WAVL){
+            DroneWavl::rebalancePath(path, depth);
+        }
+        else if (m_balance == ADAPTIVE){
+            DroneRelaxed::rebalancePath(path, depth);
+        }
+        else{
+            DroneBalance::rebalancePath(path, depth);
+        }
+    }
+    int settlePath(DroneLink* path[], int depth){ //helper for append, rebalances a path only until it stops changing
+        invalidateCache();
+        if (m_balance == WAVL){
+            return DroneWavl::settlePath(path, depth);
+        }
+        else if (m_balance == ADAPTIVE){
+            return DroneRelaxed::settlePath(path, depth);
+        }
+        return DroneBalance::settlePath(path, depth);
+    }
+    Drone* join(Drone* left, Drone* mid, Drone* right){ //helper for settleSubtree, joins two trees around a middle drone
+        if (m_balance == WAVL){
+            return DroneWavlKernels::join(left, mid, right);
+        }
+        else if (m_balance == ADAPTIVE){
+            return DroneRelaxedKernels::join(left, mid, right);
+        }
+        return DroneKernels::join(left, mid, right);
+    }
+    Drone* joinTrees(Drone* left, Drone* right){ //helper for removeRange, joins two trees with no middle drone
+        invalidateCache();
+        if (m_balance == WAVL){
+            return DroneWavlKernels::joinTrees(left, right);
+        }
+        else if (m_balance == ADAPTIVE){
+            return DroneRelaxedKernels::joinTrees(left, right);
+        }
+        return DroneKernels::joinTrees(left, right);
+    }
+    void split(Drone* curr, int id, Drone*& left, Drone*& right){ //helper for removeRange, splits a tree into IDs below id and the rest
+        if (m_balance == WAVL){
+            DroneWavlKernels::split(curr, id, left, right);
+        }
+        else if (m_balance == ADAPTIVE){
+            DroneRelaxedKernels::split(curr, id, left, right);
+        }
+        else{
+            DroneKernels::split(curr, id, left, right);
+        }
+    }
+    static bool isValid(int id, LIGHTCOLOR type, STATE state){ //helper for insert, checks the ID, light color, and state
+        return ((id >= MINID) && (id <= MAXID) && ((type == RED) || (type == GREEN) || (type == BLUE)) && ((state == LIGHTON) || (state == LIGHTOFF)));
+    }
+    INSERTRESULT append(SIDE side, int id, LIGHTCOLOR type, STATE state); //helper for insert, links a drone beyond one end through its finger
+    void walkFinger(SIDE side, int depth); //helper for append and insert, walks a finger down from its first depth links
+    bool fingerValid(SIDE side) const {return ((m_fingers[side].depth > 0) && (m_fingers[side].epoch == m_cacheEpoch));}
+    const Drone* fingerEnd(SIDE side) const {return *m_fingers[side].path[m_fingers[side].depth - 1];} //the drone at a valid finger's end
+    void relaxPath(DroneLink* path[], int depth); //helper for rebalancePath during a burst, marks the path instead
+    Drone* settleSubtree(Drone* curr); //helper for settleBurst, rebalances a subtree bottom up from the marked drones
+    void settleBurst(){ //helper for endBurst and every change that needs valid heights, the root is marked while anything is
+        if (heightOf(m_root) == DIRTY_HEIGHT){
+            invalidateCache();
+            m_root = settleSubtree(m_root);
+        }
+    }
+    void settleCounters() const { //helper for everything that reads the counters, which a burst leaves stale above each change
+        if (m_burst){
+            const_cast<Show*>(this)->settleBurst();
+        }
+    }
+    void retag(int loId, int hiId, int tag); //helper for the range updates, changes every drone with an ID in [loId, hiId] by tag
+    void applyRange(Drone* curr, int loId, int hiId, int tag, int subLo, int subHi); //helper for retag, every ID below curr is in [subLo, subHi]
+    static void reveal(const Drone* aDrone) {const_cast<Drone*>(aDrone)->pushTag();} //helper for every read, brings a drone's children up to date
+    Drone* applyBatch(Drone* curr, const DroneOp ops[], const int order[], const int ids[], int first, int last, bool done[]); //helper for apply, merges the sorted ops into a subtree
+    void applyGroup(const DroneOp ops[], const int order[], int first, int last, bool done[], Drone*& aDrone); //helper for applyBatch, runs the ops of one ID
+    void relinkBalanced(); //helper for setBalance and the assignment operator, relinks the tree as a perfectly balanced one
+    void adapt(int id); //helper for findDrone and setState, counts an access and lifts the drone above less used parents
+    void invalidateCache() {m_cacheEpoch++;} //helper for every change that moves or frees a drone
+    Drone* const* probe(int id, int& depth) const; //helper for findDrone and setState, the path to a drone from the hot cache or a descent
+    bool changeState(Drone* const path[], int depth, STATE state); //helper for setState, changes the state of the last drone on a path
+    void releaseSubtree(Drone* curr); //helper for removeRange, hands every drone of a subtree back to the pool
+    static int heightOf(const Drone* aDrone) {return ((aDrone == nullptr) ? -1 : aDrone->getHeight());}
+    int rebuildKept(vector<Drone*>& nodes, const vector<char>& keep, int numThreads); //helper for removeIf, releases the rest and rebuilds
+    void updateHeight(Drone* aDrone) { //helper for buildBalanced
+        if (aDrone != nullptr){
+            int leftHeight = heightOf(aDrone->getLeft());
+            int rightHeight = heightOf(aDrone->getRight());
+            aDrone->setHeight(1 + ((leftHeight > rightHeight) ? leftHeight : rightHeight));
+        }
+    }
+    void updateCounts(Drone* aDrone) {DroneTraits::pull(aDrone);} //helper for insert and remove, recomputes the subtree counters from the children
+    int countBelow(LIGHTCOLOR color, STATE state, int id) const; //helper for countDrones, counts matching drones with smaller IDs
     Drone* preOrderAssignment(const Drone* rhsDrone); //helper for the assignment operator
-    int postOrderCount(LIGHTCOLOR color, Drone* curr) const; //helper function for countDrones
+    void countPages(const Drone* curr, uintptr_t parentPage, int numPages, double& total) const; //helper for descentPages
+    static double distanceBetween(const Drone* lhs, const Drone* rhs); //helper for scanStride, in drones
+    void vebOrder(Drone* curr, int levels, vector<Drone*>& nodes); //helper for compact, lists a subtree in van Emde Boas order
+    void collectDepth(Drone* curr, int depth, vector<Drone*>& nodes); //helper for vebOrder, lists the drones at one depth of a subtree
+    void relocateStragglers(DroneLink* link); //helper for compactStep, moves every drone not yet relocated
+    void promote(); //helper for inline mode, moves the inline drones into the pool
+    void demote(); //helper for inline mode, moves every drone inline and frees the pool
+    void settleInline(); //helper for every change, promotes or demotes once the size crosses a limit
+    void relinkInline(); //helper for inline mode, links the inline array into a balanced tree
+    int searchInline(int id) const; //helper for inline mode, the position of the first inline drone not below id
+    const Drone* locate(int id) const; //helper for forEachMatching, finds the drone for an ID taken from an index
+    void indexDrone(int id, LIGHTCOLOR type, STATE state); //helper for every change, adds a drone to the bitmaps
+    void unindexDrone(int id, LIGHTCOLOR type, STATE state); //helper for every change, takes a drone out of the bitmaps
+    void rebuildIndexes(); //helper for enableIndexes and the assignment operator, fills the bitmaps from the tree
 };
-#endif
\ No newline at end of file
+
+//bulkLoad
+//copies the range into a roster, then sorts, dedupes, and builds the whole tree at once
+template <class Iterator>
+int Show::bulkLoad(Iterator first, Iterator last, int numThreads){
+    vector<Drone> roster(first, last);
+    return loadRoster(roster, numThreads);
+}
+
+//removeIf
+//flattens the tree, tests every drone, then rebuilds a balanced tree from the survivors in one linear pass
+//with more than one thread the predicate is split across threads, so it must be safe to call concurrently
+template <class Predicate>
+int Show::removeIf(Predicate shouldRemove, int numThreads){
+    //the inline drones are not the pool's to release, so they are moved into it first
+    if (m_inlineMode){
+        promote();
+    }
+    vector<Drone*> nodes;
+    nodes.reserve(m_pool.inUse());
+    flattenInorder(m_root, nodes);
+    vector<char> keep(nodes.size());
+
+    //if statement checks if the predicate is worth splitting across threads
+    if ((numThreads > 1) && (nodes.size() >= PARALLEL_BUILD)){
+        vector<thread> testers;
+        int chunk = (nodes.size() + numThreads - 1) / numThreads;
+        for (unsigned int start = 0; start < nodes.size(); start += chunk){
+            unsigned int end = ((start + chunk < nodes.size()) ? start + chunk : nodes.size());
+            testers.push_back(thread([&, start, end](){
+                for (unsigned int i = start; i < end; i++){
+                    keep[i] = !shouldRemove(static_cast<const Drone&>(*nodes[i]));
+                }
+            }));
+        }
+        for (unsigned int i = 0; i < testers.size(); i++){
+            testers[i].join();
+        }
+    }
+    else{
+        for (unsigned int i = 0; i < nodes.size(); i++){
+            keep[i] = !shouldRemove(static_cast<const Drone&>(*nodes[i]));
+        }
+    }
+    return rebuildKept(nodes, keep, numThreads);
+}
+
+//forEachInRange
+//stacks the drones at or above loId on the way down, then lists in order until hiId is passed
+//only the path to loId and the drones in range are visited, so it costs O(log n + k)
+template <class Function>
+void Show::forEachInRange(int loId, int hiId, Function visit) const{
+    const Drone* stack[MAXDEPTH];
+    int depth = 0;
+    const Drone* curr = m_root;
+    while (curr != nullptr){
+        reveal(curr);
+        if (curr->getID() >= loId){
+            stack[depth++] = curr;
+            curr = curr->getLeft();
+        }
+        else{
+            curr = curr->getRight();
+        }
+    }
+    while (depth > 0){
+        curr = stack[--depth];
+        if (curr->getID() > hiId){
+            return;
+        }
+        visit(*curr);
+        for (curr = curr->getRight(); curr != nullptr; curr = curr->getLeft()){
+            reveal(curr);
+            stack[depth++] = curr;
+        }
+    }
+}
+
+//forEachMatching
+//with indexes the two bitmaps are intersected and only the hits are found in the tree, so it costs O(k log n)
+//without them every drone is checked in order
+//visit must not change the tree
+template <class Function>
+void Show::forEachMatching(LIGHTCOLOR aColor, STATE aState, Function visit) const{
+    if ((aColor < RED) || (aColor > BLUE) || (aState < LIGHTON) || (aState > LIGHTOFF)){
+        return;
+    }
+    if (m_indexed){
+        DroneBitmap::forEachIntersection(m_colorIndex[aColor], m_stateIndex[aState], [&](int id){visit(*locate(id));});
+    }
+    else{
+        for (const Drone& curr : *this){
+            if ((curr.getType() == aColor) && (curr.getState() == aState)){
+                visit(curr);
+            }
+        }
+    }
+}
+
+//forEachMatching
+//walks the color's bitmap, or every drone without indexes
+template <class Function>
+void Show::forEachMatching(LIGHTCOLOR aColor, Function visit) const{
+    if ((aColor < RED) || (aColor > BLUE)){
+        return;
+    }
+    if (m_indexed){
+        m_colorIndex[aColor].forEach([&](int id){visit(*locate(id));});
+    }
+    else{
+        for (const Drone& curr : *this){
+            if (curr.getType() == aColor){
+                visit(curr);
+            }
+        }
+    }
+}
+
+//forEachMatching
+//walks the state's bitmap, or every drone without indexes
+template <class Function>
+void Show::forEachMatching(STATE aState, Function visit) const{
+    if ((aState < LIGHTON) || (aState > LIGHTOFF)){
+        return;
+    }
+    if (m_indexed){
+        m_stateIndex[aState].forEach([&](int id){visit(*locate(id));});
+    }
+    else{
+        for (const Drone& curr : *this){
+            if (curr.getState() == aState){
+                visit(curr);
+            }
+        }
+    }
+}
+#endif
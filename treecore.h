@@ -0,0 +1,701 @@
+// Extension of UMBC - CMSC 341 - Spring 2023 - Proj2, added by the Show maintainers
+#ifndef TREECORE_H
+#define TREECORE_H
+#include <functional>
+const int MAXDEPTH = 64;//upper bound on the depth of a descent path, an AVL tree of MAXID nodes is far shorter
+
+//Node traits
+//every kernel below reaches a node only through a traits class, which any node type can supply:
+//  typedef Node, Key, and Compare
+//  static Key key(const Node*)
+//  static Node* left(const Node*), right(const Node*), and setLeft(Node*, Node*), setRight(Node*, Node*)
+//  static int height(const Node*) and setHeight(Node*, int)
+//  static void pull(Node*), which recomputes whatever the node sums up from its children, such as sizes
+//  static void push(Node*), which hands down to the children whatever the node still holds for its whole subtree
+//the kernels push a node before moving its children and pull it afterwards, update and pull expect nothing left to hand down
+//all of these are inline, so an instantiation compiles down to the same code as one written for that node
+
+template <class Traits, class Policy>
+class TreeKernels;
+
+//HeightPolicy
+//balance policy keeping the heights of every node's children within SLACK of each other
+//SLACK 1 is AVL, a larger slack leaves room to reshape the tree, the height bound grows to about 2.4 log n for SLACK 4
+template <class Traits, int SLACK>
+class HeightPolicy{
+    public:
+    typedef typename Traits::Node Node;
+    static const int slack = SLACK;
+
+    static int heightOf(const Node* aNode) {return ((aNode == nullptr) ? -1 : Traits::height(aNode));}
+    static int higher(int lhs, int rhs) {return ((lhs > rhs) ? lhs : rhs);}
+
+    //rotations
+    //the rotations done by this thread in every tree using the policy, a double rotation counts as two
+    static long long& rotations(){
+        static thread_local long long count = 0;
+        return count;
+    }
+
+    //update
+    //recomputes the height and the pulled data of a node whose children changed
+    static void update(Node* aNode){
+        int leftHeight = heightOf(Traits::left(aNode));
+        int rightHeight = heightOf(Traits::right(aNode));
+        Traits::setHeight(aNode, 1 + ((leftHeight > rightHeight) ? leftHeight : rightHeight));
+        Traits::pull(aNode);
+    }
+
+    static bool isBalanced(const Node* aNode){
+        int heightDifference = heightOf(Traits::left(aNode)) - heightOf(Traits::right(aNode));
+        return (heightDifference >= -SLACK) && (heightDifference <= SLACK);
+    }
+
+    //rebalance
+    //updates one node whose children changed, and restructures it if it became imbalanced
+    //the child heights read for the balance check also pick the rotation, so the kernels below never search for the tallest child
+    //with more slack than AVL a join can leave children further apart than one rotation fixes, so they are joined again
+    static Node* rebalance(Node* curr){
+        Traits::push(curr);
+        Node* left = Traits::left(curr);
+        Node* right = Traits::right(curr);
+        int leftHeight = heightOf(left);
+        int rightHeight = heightOf(right);
+        int heightDifference = leftHeight - rightHeight;
+        if ((heightDifference >= -SLACK) && (heightDifference <= SLACK)){
+            Traits::setHeight(curr, 1 + higher(leftHeight, rightHeight));
+            Traits::pull(curr);
+            return curr;
+        }
+        if (heightDifference == SLACK + 1){
+            int innerHeight = heightOf(Traits::right(left));
+            int outerHeight = heightOf(Traits::left(left));
+            return ((outerHeight >= innerHeight) ? rotateLL(curr, outerHeight, rightHeight) : rotateLR(curr, outerHeight, rightHeight));
+        }
+        if (heightDifference == -SLACK - 1){
+            int innerHeight = heightOf(Traits::left(right));
+            int outerHeight = heightOf(Traits::right(right));
+            //with equally tall children, which removes and joins can cause, the double rotation is only balanced
+            //when the inner child's right subtree is as tall as curr's left one, otherwise the single rotation is used
+            //with more slack the single rotation is always balanced
+            bool single = (outerHeight > innerHeight) || ((outerHeight == innerHeight)
+                          && ((SLACK > 1) || (heightOf(Traits::right(Traits::left(right))) != innerHeight - 1)));
+            return (single ? rotateRR(curr, leftHeight, outerHeight) : rotateRL(curr, leftHeight, outerHeight));
+        }
+        return TreeKernels<Traits, HeightPolicy>::join(left, curr, right);
+    }
+
+    //rotateLL
+    //z's left child y is too tall through its own left child, so y is lifted over z
+    //the heights of y's left subtree and z's right one are already known, so only the moved subtree is read
+    static Node* rotateLL(Node* z, int yLeftHeight, int zRightHeight){
+        Node* y = Traits::left(z);
+        Traits::push(y);
+        Node* moved = Traits::right(y);
+        Traits::setLeft(z, moved);
+        Traits::setRight(y, z);
+        int zHeight = 1 + higher(heightOf(moved), zRightHeight);
+        Traits::setHeight(z, zHeight);
+        Traits::pull(z);
+        Traits::setHeight(y, 1 + higher(yLeftHeight, zHeight));
+        Traits::pull(y);
+        rotations() += 1;
+        return y;
+    }
+
+    //rotateRR
+    //the mirror image of rotateLL
+    static Node* rotateRR(Node* z, int zLeftHeight, int yRightHeight){
+        Node* y = Traits::right(z);
+        Traits::push(y);
+        Node* moved = Traits::left(y);
+        Traits::setRight(z, moved);
+        Traits::setLeft(y, z);
+        int zHeight = 1 + higher(zLeftHeight, heightOf(moved));
+        Traits::setHeight(z, zHeight);
+        Traits::pull(z);
+        Traits::setHeight(y, 1 + higher(zHeight, yRightHeight));
+        Traits::pull(y);
+        rotations() += 1;
+        return y;
+    }
+
+    //rotateLR
+    //z's left child y is too tall through its right child x, so x is lifted over both and takes y and z as children
+    static Node* rotateLR(Node* z, int yLeftHeight, int zRightHeight){
+        Node* y = Traits::left(z);
+        Traits::push(y);
+        Node* x = Traits::right(y);
+        Traits::push(x);
+        Node* t1 = Traits::left(x);
+        Node* t2 = Traits::right(x);
+        Traits::setRight(y, t1);
+        Traits::setLeft(z, t2);
+        Traits::setLeft(x, y);
+        Traits::setRight(x, z);
+        int yHeight = 1 + higher(yLeftHeight, heightOf(t1));
+        int zHeight = 1 + higher(heightOf(t2), zRightHeight);
+        Traits::setHeight(y, yHeight);
+        Traits::pull(y);
+        Traits::setHeight(z, zHeight);
+        Traits::pull(z);
+        Traits::setHeight(x, 1 + higher(yHeight, zHeight));
+        Traits::pull(x);
+        rotations() += 2;
+        return x;
+    }
+
+    //rotateRL
+    //the mirror image of rotateLR
+    static Node* rotateRL(Node* z, int zLeftHeight, int yRightHeight){
+        Node* y = Traits::right(z);
+        Traits::push(y);
+        Node* x = Traits::left(y);
+        Traits::push(x);
+        Node* t1 = Traits::left(x);
+        Node* t2 = Traits::right(x);
+        Traits::setRight(z, t1);
+        Traits::setLeft(y, t2);
+        Traits::setLeft(x, z);
+        Traits::setRight(x, y);
+        int zHeight = 1 + higher(zLeftHeight, heightOf(t1));
+        int yHeight = 1 + higher(heightOf(t2), yRightHeight);
+        Traits::setHeight(z, zHeight);
+        Traits::pull(z);
+        Traits::setHeight(y, yHeight);
+        Traits::pull(y);
+        Traits::setHeight(x, 1 + higher(zHeight, yHeight));
+        Traits::pull(x);
+        rotations() += 2;
+        return x;
+    }
+
+    //rebalancePath
+    //walks a descent path of links back up, fixing heights and restructuring any node that is now imbalanced
+    //a link is anything that reads and writes like a Node*, such as Drone's 32-bit DroneLink
+    template <class Link>
+    static void rebalancePath(Link* path[], int depth){
+        for (int i = settlePath(path, depth); i >= 0; i--){
+            Traits::pull(*path[i]);
+        }
+    }
+
+    //settlePath
+    //the structural half of rebalancePath, once a subtree's height stops changing no ancestor can become imbalanced
+    //so the climb stops there, returning the position of the lowest node left with stale pulled data, -1 if none
+    template <class Link>
+    static int settlePath(Link* path[], int depth){
+        for (int i = depth - 1; i >= 0; i--){
+            int oldHeight = Traits::height(*path[i]);
+            *path[i] = rebalance(*path[i]);
+            if (Traits::height(*path[i]) == oldHeight){
+                return i - 1;
+            }
+        }
+        return -1;
+    }
+};
+
+//AvlPolicy
+//balance policy keeping the heights of every node's children within one of each other
+template <class Traits>
+class AvlPolicy : public HeightPolicy<Traits, 1> {};
+
+//RelaxedAvlPolicy
+//balance policy letting the heights of a node's children differ by up to four, which Show's adaptive mode reshapes within
+template <class Traits>
+class RelaxedAvlPolicy : public HeightPolicy<Traits, 4> {};
+
+//WavlPolicy
+//weak AVL balance policy, the height field holds a rank instead and every node's rank is one or two above each child's
+//a missing child has rank -1, and a leaf has rank 0
+//inserts fix a child of equal rank by promoting upward, removes fix a child three below, or a leaf of rank 1, by demoting upward
+//either ends with at most two rotations, so an update does O(1) amortized rotations where AVL removes can do O(log n)
+//a tree built with heights as ranks, like any AVL tree, is already a valid WAVL tree
+template <class Traits>
+class WavlPolicy{
+    public:
+    typedef typename Traits::Node Node;
+
+    static int heightOf(const Node* aNode) {return ((aNode == nullptr) ? -1 : Traits::height(aNode));}
+
+    //rotations
+    //the rotations done by this thread in every tree using the policy, a double rotation counts as two
+    static long long& rotations(){
+        static thread_local long long count = 0;
+        return count;
+    }
+
+    //update
+    //gives a node whose children were just linked the rank one above its higher child, as buildBalanced and join need
+    static void update(Node* aNode){
+        int leftRank = heightOf(Traits::left(aNode));
+        int rightRank = heightOf(Traits::right(aNode));
+        Traits::setHeight(aNode, 1 + ((leftRank > rightRank) ? leftRank : rightRank));
+        Traits::pull(aNode);
+    }
+
+    static bool isBalanced(const Node* aNode){
+        int rank = Traits::height(aNode);
+        int leftDifference = rank - heightOf(Traits::left(aNode));
+        int rightDifference = rank - heightOf(Traits::right(aNode));
+        bool isLeaf = (Traits::left(aNode) == nullptr) && (Traits::right(aNode) == nullptr);
+        return (leftDifference >= 1) && (leftDifference <= 2) && (rightDifference >= 1) && (rightDifference <= 2) && !(isLeaf && (rank != 0));
+    }
+
+    //rebalance
+    //fixes one node after one of its children changed, which leaves at most one violation at the node
+    //a promote or demote changes the node's rank and passes the violation to its parent, a rotation ends it
+    static Node* rebalance(Node* x){
+        Traits::push(x);
+        Traits::pull(x);
+        int rank = Traits::height(x);
+        Node* left = Traits::left(x);
+        Node* right = Traits::right(x);
+        if ((left != nullptr) && (heightOf(left) == rank)){
+            return fixInsert(x, false);
+        }
+        if ((right != nullptr) && (heightOf(right) == rank)){
+            return fixInsert(x, true);
+        }
+        if (rank - heightOf(left) == 3){
+            return fixRemove(x, true);
+        }
+        if (rank - heightOf(right) == 3){
+            return fixRemove(x, false);
+        }
+        if ((left == nullptr) && (right == nullptr) && (rank != 0)){
+            Traits::setHeight(x, 0);//a leaf left with rank 1 by a remove, it is demoted
+        }
+        return x;
+    }
+
+    //rebalancePath
+    //walks a descent path of links back up, fixing each node in turn
+    template <class Link>
+    static void rebalancePath(Link* path[], int depth){
+        for (int i = settlePath(path, depth); i >= 0; i--){
+            Traits::pull(*path[i]);
+        }
+    }
+
+    //settlePath
+    //the structural half of rebalancePath, once a subtree's rank stops changing its parent has no violation
+    //so the climb stops there, returning the position of the lowest node left with stale pulled data, -1 if none
+    template <class Link>
+    static int settlePath(Link* path[], int depth){
+        for (int i = depth - 1; i >= 0; i--){
+            int oldRank = Traits::height(*path[i]);
+            *path[i] = rebalance(*path[i]);
+            if (Traits::height(*path[i]) == oldRank){
+                return i - 1;
+            }
+        }
+        return -1;
+    }
+
+    private:
+    static Node* child(const Node* aNode, bool isRight) {return (isRight ? Traits::right(aNode) : Traits::left(aNode));}
+    static void setChild(Node* aNode, bool isRight, Node* aChild){
+        if (isRight){
+            Traits::setRight(aNode, aChild);
+        }
+        else{
+            Traits::setLeft(aNode, aChild);
+        }
+    }
+    static void addRank(Node* aNode, int amount) {Traits::setHeight(aNode, Traits::height(aNode) + amount);}
+
+    //rotate
+    //lifts the child of aNode on the given side above it, and returns the child
+    static Node* rotate(Node* aNode, bool isRight){
+        Node* lifted = child(aNode, isRight);
+        Traits::push(aNode);
+        Traits::push(lifted);
+        setChild(aNode, isRight, child(lifted, !isRight));
+        setChild(lifted, !isRight, aNode);
+        Traits::pull(aNode);
+        Traits::pull(lifted);
+        rotations()++;
+        return lifted;
+    }
+
+    //fixInsert
+    //x has a child y of its own rank on side isRight
+    //x is promoted if its other child is one below it, otherwise one or two rotations bring the subtree back to x's rank
+    static Node* fixInsert(Node* x, bool isRight){
+        int rank = Traits::height(x);
+        if (rank - heightOf(child(x, !isRight)) == 1){
+            addRank(x, 1);
+            return x;
+        }
+        Node* y = child(x, isRight);
+        Node* outer = child(y, isRight);
+        if (rank - heightOf(outer) == 1){
+            addRank(x, -1);
+            return rotate(x, isRight);
+        }
+        Node* inner = child(y, !isRight);
+        addRank(x, -1);
+        addRank(y, -1);
+        addRank(inner, 1);
+        setChild(x, isRight, rotate(y, !isRight));
+        return rotate(x, isRight);
+    }
+
+    //fixRemove
+    //x has a child three below it on the side opposite isRight, or is missing one there, and its sibling s is on side isRight
+    //x is demoted when s is two below it, x and s are both demoted when s's children are both two below s
+    //otherwise one or two rotations toward the short side bring the subtree back to x's rank
+    static Node* fixRemove(Node* x, bool isRight){
+        int rank = Traits::height(x);
+        Node* s = child(x, isRight);
+        if (rank - heightOf(s) == 2){
+            addRank(x, -1);
+            return x;
+        }
+        int sRank = Traits::height(s);
+        Node* outer = child(s, isRight);
+        Node* inner = child(s, !isRight);
+        if ((sRank - heightOf(outer) == 2) && (sRank - heightOf(inner) == 2)){
+            addRank(x, -1);
+            addRank(s, -1);
+            return x;
+        }
+        if (sRank - heightOf(outer) == 1){
+            addRank(s, 1);
+            addRank(x, -1);
+            if ((child(x, !isRight) == nullptr) && (inner == nullptr)){
+                addRank(x, -1);//x is about to become a leaf, which must have rank 0
+            }
+            return rotate(x, isRight);
+        }
+        addRank(inner, 2);
+        addRank(x, -2);
+        addRank(s, -1);
+        setChild(x, isRight, rotate(s, !isRight));
+        return rotate(x, isRight);
+    }
+};
+
+//TreeKernels
+//the ordered tree algorithms which do not depend on how nodes are stored, for any traits and balance policy
+template <class Traits, class Policy>
+class TreeKernels{
+    public:
+    typedef typename Traits::Node Node;
+    typedef typename Traits::Key Key;
+
+    //join
+    //joins left, mid, and right where every key in left is below mid's and every key in right is above it
+    //the shorter tree is hung from the spine of the taller one at matching height, costing O(difference in heights)
+    static Node* join(Node* left, Node* mid, Node* right){
+        if (Policy::heightOf(left) > Policy::heightOf(right) + 1){
+            Traits::push(left);
+            Traits::setRight(left, join(Traits::right(left), mid, right));
+            return Policy::rebalance(left);
+        }
+        else if (Policy::heightOf(right) > Policy::heightOf(left) + 1){
+            Traits::push(right);
+            Traits::setLeft(right, join(left, mid, Traits::left(right)));
+            return Policy::rebalance(right);
+        }
+        Traits::setLeft(mid, left);
+        Traits::setRight(mid, right);
+        Policy::update(mid);
+        return mid;
+    }
+
+    //detachMin
+    //unlinks the node with the smallest key from the subtree, rebalancing on the way back up
+    static Node* detachMin(Node* curr, Node*& minNode){
+        Traits::push(curr);
+        if (Traits::left(curr) == nullptr){
+            minNode = curr;
+            return Traits::right(curr);
+        }
+        Traits::setLeft(curr, detachMin(Traits::left(curr), minNode));
+        return Policy::rebalance(curr);
+    }
+
+    //joinTrees
+    //joins two trees where every key in left is below every key in right, the smallest node of right becomes the middle
+    static Node* joinTrees(Node* left, Node* right){
+        if (left == nullptr){
+            return right;
+        }
+        if (right == nullptr){
+            return left;
+        }
+        Node* minNode;
+        right = detachMin(right, minNode);
+        return join(left, minNode, right);
+    }
+
+    //split
+    //splits the subtree into left, holding the keys below key, and right, holding the rest, in O(log n)
+    static void split(Node* curr, const Key& key, Node*& left, Node*& right){
+        if (curr == nullptr){
+            left = nullptr;
+            right = nullptr;
+        }
+        else if (typename Traits::Compare()(Traits::key(curr), key)){
+            Traits::push(curr);
+            Node* lower;
+            split(Traits::right(curr), key, lower, right);
+            left = join(Traits::left(curr), curr, lower);
+        }
+        else{
+            Traits::push(curr);
+            Node* upper;
+            split(Traits::left(curr), key, left, upper);
+            right = join(upper, curr, Traits::right(curr));
+        }
+    }
+
+    //buildBalanced
+    //links nodes already in key order into a balanced tree, the middle node becomes the root
+    static Node* buildBalanced(Node** nodes, int numNodes){
+        if (numNodes == 0){
+            return nullptr;
+        }
+        int mid = numNodes / 2;
+        Node* curr = nodes[mid];
+        Traits::setLeft(curr, buildBalanced(nodes, mid));
+        Traits::setRight(curr, buildBalanced(nodes + mid + 1, numNodes - mid - 1));
+        Policy::update(curr);
+        return curr;
+    }
+};
+
+//TreeNode
+//node of a TreeCore, a key and its payload plus the links and the size of its subtree
+template <class Key, class Payload>
+class TreeNode{
+    public:
+    TreeNode(const Key& key, const Payload& payload) : m_key(key), m_payload(payload), m_left(nullptr), m_right(nullptr), m_height(0), m_size(1) {}
+    const Key& getKey() const {return m_key;}
+    Payload& getPayload() {return m_payload;}
+    const Payload& getPayload() const {return m_payload;}
+    TreeNode* getLeft() const {return m_left;}
+    TreeNode* getRight() const {return m_right;}
+    int getHeight() const {return m_height;}
+    int getSize() const {return m_size;}
+
+    Key m_key;
+    Payload m_payload;
+    TreeNode* m_left;
+    TreeNode* m_right;
+    int m_height;
+    int m_size;//the number of nodes in this subtree, including this one
+};
+
+//TreeNodeTraits
+//traits for TreeNode, whose pulled data is the subtree size
+template <class KeyType, class PayloadType, class KeyCompare>
+class TreeNodeTraits{
+    public:
+    typedef TreeNode<KeyType, PayloadType> Node;
+    typedef KeyType Key;
+    typedef KeyCompare Compare;
+    static const Key& key(const Node* aNode) {return aNode->m_key;}
+    static Node* left(const Node* aNode) {return aNode->m_left;}
+    static Node* right(const Node* aNode) {return aNode->m_right;}
+    static void setLeft(Node* aNode, Node* child) {aNode->m_left = child;}
+    static void setRight(Node* aNode, Node* child) {aNode->m_right = child;}
+    static int height(const Node* aNode) {return aNode->m_height;}
+    static void setHeight(Node* aNode, int height) {aNode->m_height = height;}
+    static void pull(Node* aNode){
+        aNode->m_size = 1 + ((aNode->m_left == nullptr) ? 0 : aNode->m_left->m_size)
+                          + ((aNode->m_right == nullptr) ? 0 : aNode->m_right->m_size);
+    }
+    static void push(Node*) {}//a TreeNode holds nothing back from its children
+};
+
+//TreeCore
+//ordered map from Key to Payload built on the kernels above, for fleets that need wider keys or more data than Drone
+//Compare orders the keys and BalancePolicy is instantiated with the node traits, both are resolved at compile time
+template <class Key, class Payload, class Compare = std::less<Key>, template <class> class BalancePolicy = AvlPolicy>
+class TreeCore{
+    public:
+    typedef TreeNode<Key, Payload> Node;
+
+    TreeCore() : m_root(nullptr) {}
+    ~TreeCore() {clear();}
+    TreeCore(const TreeCore&) = delete;
+    TreeCore& operator=(const TreeCore&) = delete;
+
+    //insert
+    //one descent keeping the links followed, then the policy rebalances the path, returns false for a duplicate key
+    bool insert(const Key& key, const Payload& payload){
+        Node** path[MAXDEPTH];
+        int depth = 0;
+        Node** link = &m_root;
+        while (*link != nullptr){
+            if (!Compare()(key, (*link)->m_key) && !Compare()((*link)->m_key, key)){
+                return false;
+            }
+            path[depth++] = link;
+            link = (Compare()(key, (*link)->m_key) ? &(*link)->m_left : &(*link)->m_right);
+        }
+        *link = new Node(key, payload);
+        Policy::rebalancePath(path, depth);
+        return true;
+    }
+
+    //remove
+    //a node with two children takes its successor's key and payload, and the successor's node is unlinked instead
+    bool remove(const Key& key){
+        Node** path[MAXDEPTH];
+        int depth = 0;
+        Node** link = &m_root;
+        while ((*link != nullptr) && (Compare()(key, (*link)->m_key) || Compare()((*link)->m_key, key))){
+            path[depth++] = link;
+            link = (Compare()(key, (*link)->m_key) ? &(*link)->m_left : &(*link)->m_right);
+        }
+        if (*link == nullptr){
+            return false;
+        }
+        Node* target = *link;
+        if ((target->m_left != nullptr) && (target->m_right != nullptr)){
+            path[depth++] = link;
+            Node** successorLink = &target->m_right;
+            while ((*successorLink)->m_left != nullptr){
+                path[depth++] = successorLink;
+                successorLink = &(*successorLink)->m_left;
+            }
+            Node* successor = *successorLink;
+            target->m_key = successor->m_key;
+            target->m_payload = successor->m_payload;
+            *successorLink = successor->m_right;
+            delete successor;
+        }
+        else{
+            *link = ((target->m_left != nullptr) ? target->m_left : target->m_right);
+            delete target;
+        }
+        Policy::rebalancePath(path, depth);
+        return true;
+    }
+
+    //find
+    //the payload stored for key, nullptr if the key is absent
+    const Payload* find(const Key& key) const{
+        const Node* curr = m_root;
+        while (curr != nullptr){
+            if (Compare()(key, curr->m_key)){
+                curr = curr->m_left;
+            }
+            else if (Compare()(curr->m_key, key)){
+                curr = curr->m_right;
+            }
+            else{
+                return &curr->m_payload;
+            }
+        }
+        return nullptr;
+    }
+
+    //rank
+    //the number of keys below key
+    int rank(const Key& key) const{
+        int position = 0;
+        for (const Node* curr = m_root; curr != nullptr;){
+            if (Compare()(curr->m_key, key)){
+                position += 1 + sizeOf(curr->m_left);
+                curr = curr->m_right;
+            }
+            else{
+                curr = curr->m_left;
+            }
+        }
+        return position;
+    }
+
+    //select
+    //the node at position k in key order, counting from 0, nullptr if out of range
+    const Node* select(int k) const{
+        const Node* curr = m_root;
+        while (curr != nullptr){
+            int leftSize = sizeOf(curr->m_left);
+            if (k < leftSize){
+                curr = curr->m_left;
+            }
+            else if (k > leftSize){
+                k -= leftSize + 1;
+                curr = curr->m_right;
+            }
+            else{
+                return curr;
+            }
+        }
+        return nullptr;
+    }
+
+    //removeRange
+    //splits off the keys in [lo, hi], deletes them, and joins the rest back together, returns how many were removed
+    int removeRange(const Key& lo, const Key& hi){
+        Node* below;
+        Node* rest;
+        Node* inRange;
+        Node* above;
+        Kernels::split(m_root, lo, below, rest);
+        Kernels::split(rest, hi, inRange, above);
+        //split keeps a key equal to hi on the upper side, so it is detached from there
+        if ((above != nullptr) && !Compare()(hi, firstOf(above)->m_key)){
+            Node* equalHi;
+            above = Kernels::detachMin(above, equalHi);
+            inRange = Kernels::join(inRange, equalHi, nullptr);
+        }
+        int numRemoved = sizeOf(inRange);
+        deleteSubtree(inRange);
+        m_root = Kernels::joinTrees(below, above);
+        return numRemoved;
+    }
+
+    //forEach
+    //calls visit on every node in key order
+    template <class Function>
+    void forEach(Function visit) const{
+        const Node* stack[MAXDEPTH];
+        int depth = 0;
+        for (const Node* curr = m_root; (curr != nullptr) || (depth > 0);){
+            if (curr != nullptr){
+                stack[depth++] = curr;
+                curr = curr->m_left;
+            }
+            else{
+                curr = stack[--depth];
+                visit(*curr);
+                curr = curr->m_right;
+            }
+        }
+    }
+
+    void clear() {deleteSubtree(m_root); m_root = nullptr;}
+    int size() const {return sizeOf(m_root);}
+    const Node* root() const {return m_root;}
+
+    private:
+    typedef TreeNodeTraits<Key, Payload, Compare> Traits;
+    typedef BalancePolicy<Traits> Policy;
+    typedef TreeKernels<Traits, Policy> Kernels;
+
+    Node* m_root;
+
+    static int sizeOf(const Node* aNode) {return ((aNode == nullptr) ? 0 : aNode->m_size);}
+    static const Node* firstOf(const Node* curr){
+        while (curr->m_left != nullptr){
+            curr = curr->m_left;
+        }
+        return curr;
+    }
+    static void deleteSubtree(Node* curr){
+        if (curr != nullptr){
+            deleteSubtree(curr->m_left);
+            deleteSubtree(curr->m_right);
+            delete curr;
+        }
+    }
+};
+#endif